@@ -0,0 +1,19 @@
+/**
+ * @file bench.c
+ * @brief cycle counter used to measure how long code takes to run on the cybot
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+#include "bench.h"
+#include "tm4c123gh6pm.h"
+
+/**
+ * Start the free running cpu cycle counter
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void bench_init(void){
+    NVIC_DBG_INT_R |= DEMCR_TRCENA;//turn on the trace unit so the DWT registers can be used
+    DWT_CYCCNT_R = 0;
+    DWT_CTRL_R |= DWT_CTRL_CYCCNTENA;
+}
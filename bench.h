@@ -0,0 +1,35 @@
+/**
+ * @file bench.h
+ * @brief cycle counter used to measure how long code takes to run on the cybot
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdint.h>
+
+//data watchpoint and trace unit, not in tm4c123gh6pm.h
+#define DWT_CTRL_R      (*((volatile uint32_t *)0xE0001000))
+#define DWT_CYCCNT_R    (*((volatile uint32_t *)0xE0001004))
+#define DWT_CTRL_CYCCNTENA 0x00000001
+#define DEMCR_TRCENA    0x01000000 //trace enable bit in NVIC_DBG_INT_R (DEMCR)
+
+/**
+ * Start the free running cpu cycle counter
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void bench_init(void);
+/**
+ * Current cpu cycle count, subtract two readings to time code, wraps every 268 s at 16 MHz
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return cycles since bench_init
+ */
+static inline uint32_t bench_cycles(void){
+    return DWT_CYCCNT_R;
+}
+
+#endif /* BENCH_H_ */
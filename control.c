@@ -0,0 +1,269 @@
+/**
+ * @file control.c
+ * @brief closed loop wheel speed and heading control, tracks a target linear and angular velocity from the encoder counts
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+#include "control.h"
+#include <math.h>
+#include "Timer.h"
+#include "open_interface.h"
+#include "odometry.h"
+
+#define CTRL_MAX_DT 0.1f //s, a longer gap between frames is treated as one frame so a stall can't wind up the integrals
+#define CTRL_STILL 3 //frames without encoder counts that show a script motion is over
+
+//the wheel integral is the distance a wheel is behind where it should be, so the wheels cover the same distance on a straight run
+ctrl_pid_t ctrl_wheel[2] = {
+    {0.8f, 4.0f, 0, 25, 0, 0},
+    {0.8f, 4.0f, 0, 25, 0, 0},
+};
+ctrl_pid_t ctrl_heading = {4.0f, 1.0f, 0, 5, 0, 0};
+int ctrl_mode = CTRL_IDLE;
+float ctrl_speed; //mm/s along the heading
+float ctrl_rate; //deg/s ccw, while rotating
+float ctrl_target; //heading to hold or turn to
+float ctrl_cruise; //mm/s, ctrl_move speed
+float ctrl_remaining; //mm ctrl_move still has to drive
+uint32_t ctrl_end; //timer_now a script motion should be over by
+uint32_t ctrl_deadline; //timer_now a script motion is given up on, in case the stream stops
+int ctrl_still; //frames in a row the wheels have not moved
+uint16_t ctrl_left, ctrl_right; //encoder counts at the last update
+uint32_t ctrl_frame; //odo_frames at the last update
+uint32_t ctrl_time; //timer_now at the last update
+
+/**
+ * Wrap an angle to -180 to 180 degrees
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param a angle in degrees
+ * @return the same direction between -180 and 180
+ */
+static inline float ctrl_wrap(float a){
+    while(a > 180)
+        a -= 360;
+    while(a < -180)
+        a += 360;
+    return a;
+}
+/**
+ * Run a PID loop once, the integral is not grown while the output is saturated in the direction of the error
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param pid loop
+ * @param err target minus measured
+ * @param dt seconds since the last update
+ * @param bias feed forward added to the output
+ * @param max output clamp, both directions
+ * @return output, -max to max
+ */
+float ctrl_pid(ctrl_pid_t *pid, float err, float dt, float bias, float max){
+    float integral = pid->integral + err*dt;
+    float out;
+    if(integral > pid->limit)
+        integral = pid->limit;
+    if(integral < -pid->limit)
+        integral = -pid->limit;
+    out = bias + pid->kp*err + pid->ki*integral + pid->kd*(err - pid->last)/dt;
+    pid->last = err;
+    if(out > max){
+        out = max;
+        if(err > 0)
+            return out;
+    }
+    if(out < -max){
+        out = -max;
+        if(err < 0)
+            return out;
+    }
+    pid->integral = integral;
+    return out;
+}
+/**
+ * Reset a PID loop for a new target
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param pid loop
+ */
+static inline void ctrl_reset(ctrl_pid_t *pid){
+    pid->integral = 0;
+    pid->last = 0;
+}
+/**
+ * Start a new motion from the current pose and encoder counts
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param mode CTRL_VELOCITY or CTRL_TURN
+ */
+void ctrl_begin(int mode){
+    odo_pose_t pose;
+    odo_get(&pose);
+    if(ctrl_mode == CTRL_IDLE){//keep the wheel loops running smoothly from one motion into the next
+        ctrl_reset(&ctrl_wheel[0]);
+        ctrl_reset(&ctrl_wheel[1]);
+        ctrl_left = odo_left;
+        ctrl_right = odo_right;
+        ctrl_frame = odo_frames;
+        ctrl_time = timer_now();
+    }
+    ctrl_reset(&ctrl_heading);
+    ctrl_target = pose.heading;
+    ctrl_mode = mode;
+}
+/**
+ * Wait out a motion the Create script engine is running
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param time s the motion should take
+ */
+void ctrl_script(float time){
+    ctrl_begin(CTRL_SCRIPT);
+    ctrl_still = 0;
+    ctrl_end = ctrl_time + (uint32_t)(time*1000000);
+    ctrl_deadline = ctrl_end + (uint32_t)(time*1000000) + 1000000;//twice as long and a second
+}
+/**
+ * Drive straight at a speed, holding the heading the cybot has now
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param speed mm/s, negative backwards
+ */
+void ctrl_drive(float speed){
+    ctrl_begin(CTRL_VELOCITY);
+    ctrl_speed = speed;
+    ctrl_rate = 0;
+}
+/**
+ * Turn in place at a rate until stopped
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param rate deg/s ccw, negative cw
+ */
+void ctrl_rotate(float rate){
+    ctrl_begin(CTRL_VELOCITY);
+    ctrl_speed = 0;
+    ctrl_rate = rate;
+}
+/**
+ * Turn in place by an angle, ctrl_mode goes back to CTRL_IDLE once the heading is within CTRL_TOLERANCE
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param angle degrees ccw from the current heading, negative cw, 0 settles on the current heading
+ */
+void ctrl_turn(float angle){
+#ifdef OI_SCRIPTS
+    oi_turnAngle(CTRL_TURN_RATE*(3.14159265f/180)*ODO_WHEEL_BASE/2, lroundf(angle));
+    ctrl_script(fabsf(angle)/CTRL_TURN_RATE);
+    return;
+#endif
+    ctrl_begin(CTRL_TURN);
+    ctrl_speed = 0;
+    ctrl_rate = 0;
+    ctrl_target += angle;
+    if(ctrl_target >= 360)
+        ctrl_target -= 360;
+    if(ctrl_target < 0)
+        ctrl_target += 360;
+}
+/**
+ * Drive straight by a distance, holding the heading the cybot has now, ctrl_mode goes back to CTRL_IDLE once there
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param distance mm, negative backwards
+ * @param speed mm/s, cruising speed
+ */
+void ctrl_move(float distance, float speed){
+#ifdef OI_SCRIPTS
+    oi_driveDistance(lroundf(fabsf(speed)), lroundf(distance));
+    ctrl_script(fabsf(distance/speed));
+    return;
+#endif
+    ctrl_begin(CTRL_MOVE);
+    ctrl_speed = 0;
+    ctrl_rate = 0;
+    ctrl_cruise = fabsf(speed);
+    ctrl_remaining = distance;
+}
+/**
+ * Stop the wheels now and go idle
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void ctrl_stop(void){
+    oi_setWheels(0, 0);
+    ctrl_mode = CTRL_IDLE;
+}
+/**
+ * Run the loops once for each new sensor frame and command the wheels, does nothing when idle or without a new frame
+ * The heading loop sets the turn rate while turning to an angle or driving straight, then each wheel loop tracks its share
+ * of the speed and turn rate with the target speed fed forward
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void ctrl_update(void){
+    odo_pose_t pose;
+    uint32_t now;
+    float dt, dl, dr, err, rate, spin, left, right;
+    if(ctrl_mode == CTRL_IDLE)
+        return;
+    now = timer_now();
+    if(ctrl_mode == CTRL_SCRIPT && (int32_t)(now - ctrl_deadline) > 0){
+        ctrl_stop();
+        return;
+    }
+    if(odo_frames == ctrl_frame)
+        return;
+    //the counts are as the Create sampled them, a run that merged two frames covers two periods whenever it runs
+    dt = (odo_frames - ctrl_frame)*(OI_FRAME_PERIOD/1000000.0f);
+    if(dt > CTRL_MAX_DT)
+        dt = CTRL_MAX_DT;
+    dl = (int16_t)(odo_left - ctrl_left)*ODO_MM_PER_COUNT;//counts wrap, see odo_update
+    dr = (int16_t)(odo_right - ctrl_right)*ODO_MM_PER_COUNT;
+    ctrl_left = odo_left;
+    ctrl_right = odo_right;
+    ctrl_frame = odo_frames;
+    ctrl_time = now;
+    odo_get(&pose);
+
+    if(ctrl_mode == CTRL_SCRIPT){//the Create drives, just watch for its wheels stopping
+        ctrl_still = dl == 0 && dr == 0 ? ctrl_still + 1 : 0;
+        if(ctrl_still >= CTRL_STILL && (int32_t)(now - ctrl_end) > 0)
+            ctrl_mode = CTRL_IDLE;
+        return;
+    }
+    if(ctrl_mode == CTRL_MOVE){
+        ctrl_remaining -= (dl + dr)/2;
+        if(fabsf(ctrl_remaining) < CTRL_CLOSE){
+            ctrl_stop();
+            return;
+        }
+        ctrl_speed = CTRL_APPROACH*ctrl_remaining;
+        if(ctrl_speed > ctrl_cruise)
+            ctrl_speed = ctrl_cruise;
+        if(ctrl_speed < -ctrl_cruise)
+            ctrl_speed = -ctrl_cruise;
+        if(fabsf(ctrl_speed) < CTRL_MIN_SPEED)
+            ctrl_speed = ctrl_remaining > 0 ? CTRL_MIN_SPEED : -CTRL_MIN_SPEED;
+    }
+
+    err = ctrl_wrap(ctrl_target - pose.heading);
+    if(ctrl_mode == CTRL_TURN){
+        rate = (dr - dl)/ODO_WHEEL_BASE*(180/3.14159265f)/dt;
+        if(fabsf(err) < CTRL_TOLERANCE && fabsf(rate) < CTRL_SETTLED){
+            ctrl_stop();
+            return;
+        }
+        rate = ctrl_pid(&ctrl_heading, err, dt, 0, CTRL_TURN_RATE);
+    }
+    else if(ctrl_rate == 0)
+        rate = ctrl_pid(&ctrl_heading, err, dt, 0, CTRL_TURN_RATE);//straight runs and moves hold their heading
+    else{
+        rate = ctrl_rate;
+        ctrl_target = pose.heading;
+    }
+
+    spin = rate*(3.14159265f/180)*ODO_WHEEL_BASE/2;//mm/s each wheel moves to turn at rate
+    left = ctrl_pid(&ctrl_wheel[0], ctrl_speed - spin - dl/dt, dt, ctrl_speed - spin, CTRL_MAX_SPEED);
+    right = ctrl_pid(&ctrl_wheel[1], ctrl_speed + spin - dr/dt, dt, ctrl_speed + spin, CTRL_MAX_SPEED);
+    oi_setWheels((int16_t)lroundf(right), (int16_t)lroundf(left));
+}
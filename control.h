@@ -0,0 +1,85 @@
+/**
+ * @file control.h
+ * @brief closed loop wheel speed and heading control, tracks a target linear and angular velocity from the encoder counts
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+
+#ifndef CONTROL_H_
+#define CONTROL_H_
+
+#include <stdint.h>
+
+#define CTRL_MAX_SPEED 500 //mm/s, the most oi_setWheels takes
+#define CTRL_TURN_RATE 45 //deg/s, fastest the heading loop turns
+#define CTRL_TOLERANCE 0.5f //degrees, a turn is done once this close
+#define CTRL_SETTLED 3 //deg/s, and turning slower than this
+#define CTRL_APPROACH 2.0f //mm/s of speed per mm left to drive, slows the end of ctrl_move
+#define CTRL_MIN_SPEED 15 //mm/s, ctrl_move never slows below this until it is there
+#define CTRL_CLOSE 2 //mm, ctrl_move is done once this close
+
+//build with OI_SCRIPTS defined to hand ctrl_move and ctrl_turn to the Create script engine, see oi_driveDistance
+//the MCU is free while the Create moves, but ctrl_stop and so the hazard stops can't end a motion early
+
+//ctrl_mode values
+#define CTRL_IDLE 0     //wheels are left alone
+#define CTRL_VELOCITY 1 //tracking ctrl_drive or ctrl_rotate
+#define CTRL_TURN 2     //turning to a heading, back to idle when there
+#define CTRL_MOVE 3     //driving a distance, back to idle when there
+#define CTRL_SCRIPT 4   //the Create runs the motion itself, back to idle once its wheels stop
+
+/// One PID loop, the gains can be changed at any time
+typedef struct {
+    float kp, ki, kd;
+    float limit;    //integral clamp, in error seconds
+    float integral; //error integrated over time
+    float last;     //error at the last update, for the derivative
+} ctrl_pid_t;
+
+extern ctrl_pid_t ctrl_wheel[2]; //left and right wheel speed, mm/s of correction per mm/s of error
+extern ctrl_pid_t ctrl_heading; //deg/s of turn per degree of heading error
+extern int ctrl_mode;
+
+/**
+ * Drive straight at a speed, holding the heading the cybot has now
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param speed mm/s, negative backwards
+ */
+void ctrl_drive(float speed);
+/**
+ * Turn in place at a rate until stopped
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param rate deg/s ccw, negative cw
+ */
+void ctrl_rotate(float rate);
+/**
+ * Turn in place by an angle, ctrl_mode goes back to CTRL_IDLE once the heading is within CTRL_TOLERANCE
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param angle degrees ccw from the current heading, negative cw, 0 settles on the current heading
+ */
+void ctrl_turn(float angle);
+/**
+ * Drive straight by a distance, holding the heading the cybot has now, ctrl_mode goes back to CTRL_IDLE once there
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param distance mm, negative backwards
+ * @param speed mm/s, cruising speed
+ */
+void ctrl_move(float distance, float speed);
+/**
+ * Stop the wheels now and go idle
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void ctrl_stop(void);
+/**
+ * Run the loops once for each new sensor frame and command the wheels, does nothing when idle or without a new frame
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void ctrl_update(void);
+
+#endif /* CONTROL_H_ */
@@ -0,0 +1,220 @@
+/**
+ * @file ekf.c
+ * @brief extended kalman filter over the cybot pose and the posts it has seen, odometry moves it and post sightings pull it back
+ * Sightings are range and bearing, so each touches only the pose and one landmark, the kernels below skip the zeros in
+ * the jacobians instead of doing full EKF_STATES square products
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+#include "ekf.h"
+#include <math.h>
+#include <string.h>
+
+#define EKF_PI 3.14159265f
+
+float ekf_state[EKF_STATES];
+float ekf_cov[EKF_STATES][EKF_STATES];
+int ekf_landmarks = 0;
+//scratch for the update, static so its 304 bytes show in the link map instead of on the 2 KB stack
+float ekf_pht[EKF_STATES][2]; //covariance times the measurement jacobian transposed
+float ekf_gain[EKF_STATES][2];
+
+/**
+ * Wrap an angle to -pi to pi
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param a angle in radians
+ * @return the same direction between -pi and pi
+ */
+static inline float ekf_wrap(float a){
+    while(a > EKF_PI)
+        a -= 2*EKF_PI;
+    while(a < -EKF_PI)
+        a += 2*EKF_PI;
+    return a;
+}
+/**
+ * Start over at a known pose with no landmarks
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x cell column
+ * @param y cell row
+ * @param heading ccw from +x in degrees
+ */
+void ekf_init(float x, float y, float heading){
+    memset(ekf_state, 0, sizeof(ekf_state));
+    memset(ekf_cov, 0, sizeof(ekf_cov));
+    ekf_state[0] = x;
+    ekf_state[1] = y;
+    ekf_state[2] = heading*(EKF_PI/180);
+    ekf_landmarks = 0;
+}
+/**
+ * Move the pose by one odometry step and grow its uncertainty, the mean follows odometry between sightings
+ * The step moves along the heading halfway through the turn like odo_update, so only the pose rows and columns change:
+ * P = F P F' + G M G' where F is the identity but for the heading column of x and y
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param pose odometry pose after the step
+ * @param distance mm driven in the step
+ * @param turned degrees turned ccw in the step
+ */
+void ekf_predict(const odo_pose_t *pose, float distance, float turned){
+    float d = distance/100, t = turned*(EKF_PI/180);//dm and radians
+    float mid = ekf_state[2] + t/2, c = cosf(mid), s = sinf(mid);
+    float fx = -d*s, fy = d*c; //how x and y move with the heading
+    float vd, vt, gx, gy;
+    int i;
+    ekf_state[0] = pose->x;
+    ekf_state[1] = pose->y;
+    ekf_state[2] = ekf_wrap(pose->heading*(EKF_PI/180));
+    if(d == 0 && t == 0)
+        return;
+    //rows then columns, the heading row and column are unchanged
+    for(i = 0; i < EKF_STATES; i++){
+        ekf_cov[0][i] += fx*ekf_cov[2][i];
+        ekf_cov[1][i] += fy*ekf_cov[2][i];
+    }
+    for(i = 0; i < EKF_STATES; i++){
+        ekf_cov[i][0] += fx*ekf_cov[i][2];
+        ekf_cov[i][1] += fy*ekf_cov[i][2];
+    }
+    //odometry noise, distance error along the heading and heading error that also swings the step sideways
+    vd = EKF_DIST_VAR*fabsf(d);
+    vt = EKF_TURN_VAR*fabsf(t) + EKF_DRIFT_VAR*fabsf(d);
+    gx = fx/2;
+    gy = fy/2;
+    ekf_cov[0][0] += c*c*vd + gx*gx*vt;
+    ekf_cov[0][1] += c*s*vd + gx*gy*vt;
+    ekf_cov[1][0] = ekf_cov[0][1];
+    ekf_cov[1][1] += s*s*vd + gy*gy*vt;
+    ekf_cov[0][2] += gx*vt;
+    ekf_cov[2][0] = ekf_cov[0][2];
+    ekf_cov[1][2] += gy*vt;
+    ekf_cov[2][1] = ekf_cov[1][2];
+    ekf_cov[2][2] += vt;
+}
+/**
+ * Add a landmark where a sighting puts it, its covariance comes from the pose covariance and the sighting noise
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param range dm
+ * @param bearing radians ccw from the heading
+ * @return landmark added, -1 if there is no room
+ */
+int ekf_add(float range, float bearing){
+    int n = ekf_landmarks, l = 3 + 2*n, i;
+    float a = ekf_state[2] + bearing, c = cosf(a), s = sinf(a);
+    //jacobian of the landmark position with respect to the pose heading and to range and bearing
+    float hx = -range*s, hy = range*c;
+    if(n == EKF_LANDMARKS)
+        return -1;
+    ekf_state[l] = ekf_state[0] + range*c;
+    ekf_state[l + 1] = ekf_state[1] + range*s;
+    //cross covariance with everything known so far, d(landmark)/d(pose) = [1 0 hx; 0 1 hy]
+    for(i = 0; i < l; i++){
+        ekf_cov[l][i] = ekf_cov[i][l] = ekf_cov[0][i] + hx*ekf_cov[2][i];
+        ekf_cov[l + 1][i] = ekf_cov[i][l + 1] = ekf_cov[1][i] + hy*ekf_cov[2][i];
+    }
+    ekf_cov[l][l] = ekf_cov[l][0] + hx*ekf_cov[l][2] + c*c*EKF_RANGE_VAR + hx*hx*EKF_BEARING_VAR;
+    ekf_cov[l][l + 1] = ekf_cov[l][1] + hy*ekf_cov[l][2] + c*s*EKF_RANGE_VAR + hx*hy*EKF_BEARING_VAR;
+    ekf_cov[l + 1][l] = ekf_cov[l][l + 1];
+    ekf_cov[l + 1][l + 1] = ekf_cov[l + 1][1] + hy*ekf_cov[l + 1][2] + s*s*EKF_RANGE_VAR + hy*hy*EKF_BEARING_VAR;
+    ekf_landmarks++;
+    return n;
+}
+/**
+ * Jacobian and innovation of a sighting against one landmark
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param n landmark
+ * @param range dm
+ * @param bearing radians ccw from the heading
+ * @param h filled with the range and bearing rows for x, y, heading, landmark x and landmark y
+ * @param v filled with the range and bearing innovation
+ * @param si filled with the inverse of the innovation covariance, row major 2x2
+ * @return squared mahalanobis distance of the innovation
+ */
+float ekf_innovation(int n, float range, float bearing, float h[2][5], float v[2], float si[4]){
+    int l = 3 + 2*n, c[5] = {0, 1, 2, l, l + 1}, i, j;
+    float dx = ekf_state[l] - ekf_state[0], dy = ekf_state[l + 1] - ekf_state[1];
+    float q = dx*dx + dy*dy, r = sqrtf(q), s00, s01, s11, det;
+    if(q < 0.01f)
+        q = 0.01f;//a landmark on top of the cybot has no bearing
+    if(r < 0.1f)
+        r = 0.1f;
+    h[0][0] = -dx/r; h[0][1] = -dy/r; h[0][2] = 0; h[0][3] = dx/r; h[0][4] = dy/r;
+    h[1][0] = dy/q; h[1][1] = -dx/q; h[1][2] = -1; h[1][3] = -dy/q; h[1][4] = dx/q;
+    v[0] = range - r;
+    v[1] = ekf_wrap(bearing - (atan2f(dy, dx) - ekf_state[2]));
+    //P H' over the five columns the jacobian touches, then S = H P H' + R
+    for(i = 0; i < EKF_STATES; i++){
+        ekf_pht[i][0] = ekf_pht[i][1] = 0;
+        for(j = 0; j < 5; j++){
+            ekf_pht[i][0] += ekf_cov[i][c[j]]*h[0][j];
+            ekf_pht[i][1] += ekf_cov[i][c[j]]*h[1][j];
+        }
+    }
+    s00 = EKF_RANGE_VAR;
+    s01 = 0;
+    s11 = EKF_BEARING_VAR;
+    for(j = 0; j < 5; j++){
+        s00 += h[0][j]*ekf_pht[c[j]][0];
+        s01 += h[0][j]*ekf_pht[c[j]][1];
+        s11 += h[1][j]*ekf_pht[c[j]][1];
+    }
+    det = s00*s11 - s01*s01;
+    si[0] = s11/det;
+    si[1] = si[2] = -s01/det;
+    si[3] = s00/det;
+    return v[0]*v[0]*si[0] + 2*v[0]*v[1]*si[1] + v[1]*v[1]*si[3];
+}
+/**
+ * Correct the pose and landmarks with a post seen by a sweep, it is matched to the nearest landmark or added as a new one
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param range dm from the cybot to the middle of the post
+ * @param bearing degrees ccw from the heading
+ * @return landmark it was matched to or added as, -1 if it was ignored
+ */
+int ekf_observe(float range, float bearing){
+    float h[2][5], v[2], si[4], d, best = 0;
+    int n, match = -1, i, j;
+    bearing *= EKF_PI/180;
+    for(n = 0; n < ekf_landmarks; n++){
+        d = ekf_innovation(n, range, bearing, h, v, si);
+        if(match < 0 || d < best){
+            best = d;
+            match = n;
+        }
+    }
+    if(match < 0 || best > EKF_NEW)
+        return ekf_add(range, bearing);
+    if(best > EKF_GATE)
+        return -1;//too far to trust as a match, too close to be somewhere new
+    ekf_innovation(match, range, bearing, h, v, si);
+    //K = P H' S^-1, then x += K v and P -= K (P H')'
+    for(i = 0; i < EKF_STATES; i++){
+        ekf_gain[i][0] = ekf_pht[i][0]*si[0] + ekf_pht[i][1]*si[2];
+        ekf_gain[i][1] = ekf_pht[i][0]*si[1] + ekf_pht[i][1]*si[3];
+        ekf_state[i] += ekf_gain[i][0]*v[0] + ekf_gain[i][1]*v[1];
+    }
+    ekf_state[2] = ekf_wrap(ekf_state[2]);
+    for(i = 0; i < EKF_STATES; i++)
+        for(j = 0; j <= i; j++)
+            ekf_cov[i][j] = ekf_cov[j][i] = ekf_cov[i][j] - ekf_gain[i][0]*ekf_pht[j][0] - ekf_gain[i][1]*ekf_pht[j][1];
+    return match;
+}
+/**
+ * Current pose estimate
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param pose filled with the pose
+ */
+void ekf_get(odo_pose_t *pose){
+    pose->x = ekf_state[0];
+    pose->y = ekf_state[1];
+    pose->heading = ekf_state[2]*(180/EKF_PI);
+    if(pose->heading < 0)
+        pose->heading += 360;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file ekf.h
+ * @brief extended kalman filter over the cybot pose and the posts it has seen, odometry moves it and post sightings pull it back
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+
+#ifndef EKF_H_
+#define EKF_H_
+
+#include <stdint.h>
+#include "odometry.h"
+
+#define EKF_LANDMARKS 8 //posts the filter can remember
+#define EKF_STATES (3 + 2*EKF_LANDMARKS) //x, y, heading, then x and y of each landmark
+
+//noise, position in dm and angles in radians
+#define EKF_DIST_VAR 0.004f //dm^2 of distance error per dm driven, about 2% of a 1 m run
+#define EKF_TURN_VAR 0.0006f //rad^2 of heading error per radian turned, about 2% of a 90 degree turn
+#define EKF_DRIFT_VAR 0.00003f //rad^2 of heading error per dm driven, about 1 degree per m
+#define EKF_RANGE_VAR 0.09f //dm^2, 3 cm ping range error
+#define EKF_BEARING_VAR 0.0012f //rad^2, 2 degree error in the middle of a post
+#define EKF_GATE 9.2f //squared mahalanobis distance a sighting must be under to match a landmark, 99% for 2 dimensions
+#define EKF_NEW 25.0f //and over for every landmark to be added as a new one, sightings between are ignored
+
+extern float ekf_state[EKF_STATES];
+extern float ekf_cov[EKF_STATES][EKF_STATES];
+extern int ekf_landmarks; //landmarks in use
+
+/**
+ * Start over at a known pose with no landmarks
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x cell column
+ * @param y cell row
+ * @param heading ccw from +x in degrees
+ */
+void ekf_init(float x, float y, float heading);
+/**
+ * Move the pose by one odometry step and grow its uncertainty, the mean follows odometry between sightings
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param pose odometry pose after the step
+ * @param distance mm driven in the step
+ * @param turned degrees turned ccw in the step
+ */
+void ekf_predict(const odo_pose_t *pose, float distance, float turned);
+/**
+ * Correct the pose and landmarks with a post seen by a sweep, it is matched to the nearest landmark or added as a new one
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param range dm from the cybot to the middle of the post
+ * @param bearing degrees ccw from the heading
+ * @return landmark it was matched to or added as, -1 if it was ignored
+ */
+int ekf_observe(float range, float bearing);
+/**
+ * Current pose estimate
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param pose filled with the pose
+ */
+void ekf_get(odo_pose_t *pose);
+
+#endif /* EKF_H_ */
@@ -0,0 +1,189 @@
+/**
+ * @file fixmath.c
+ * @brief fixed point sin, cos, atan2 and square root for the map and position geometry, no soft float
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+#include "fixmath.h"
+#include <math.h>
+#include <stdio.h>
+#include "bench.h"
+#include "uart.h"
+
+//sin of 0 to 90 degrees in Q15, 256 steps plus the endpoint for interpolation
+const uint16_t fix_sinTable[257] = {
+    0, 201, 402, 603, 804, 1005, 1206, 1407, 1608, 1809, 2009, 2210, 2411, 2611, 2811, 3012,
+    3212, 3412, 3612, 3812, 4011, 4211, 4410, 4609, 4808, 5007, 5205, 5404, 5602, 5800, 5998, 6195,
+    6393, 6590, 6787, 6983, 7180, 7376, 7571, 7767, 7962, 8157, 8351, 8546, 8740, 8933, 9127, 9319,
+    9512, 9704, 9896, 10088, 10279, 10469, 10660, 10850, 11039, 11228, 11417, 11605, 11793, 11980, 12167, 12354,
+    12540, 12725, 12910, 13095, 13279, 13463, 13646, 13828, 14010, 14192, 14373, 14553, 14733, 14912, 15091, 15269,
+    15447, 15624, 15800, 15976, 16151, 16326, 16500, 16673, 16846, 17018, 17190, 17361, 17531, 17700, 17869, 18037,
+    18205, 18372, 18538, 18703, 18868, 19032, 19195, 19358, 19520, 19681, 19841, 20001, 20160, 20318, 20475, 20632,
+    20788, 20943, 21097, 21251, 21403, 21555, 21706, 21856, 22006, 22154, 22302, 22449, 22595, 22740, 22884, 23028,
+    23170, 23312, 23453, 23593, 23732, 23870, 24008, 24144, 24279, 24414, 24548, 24680, 24812, 24943, 25073, 25202,
+    25330, 25457, 25583, 25708, 25833, 25956, 26078, 26199, 26320, 26439, 26557, 26674, 26791, 26906, 27020, 27133,
+    27246, 27357, 27467, 27576, 27684, 27791, 27897, 28002, 28106, 28209, 28311, 28411, 28511, 28610, 28707, 28803,
+    28899, 28993, 29086, 29178, 29269, 29359, 29448, 29535, 29622, 29707, 29792, 29875, 29957, 30038, 30118, 30196,
+    30274, 30350, 30425, 30499, 30572, 30644, 30715, 30784, 30853, 30920, 30986, 31050, 31114, 31177, 31238, 31298,
+    31357, 31415, 31471, 31527, 31581, 31634, 31686, 31737, 31786, 31834, 31881, 31927, 31972, 32015, 32058, 32099,
+    32138, 32177, 32214, 32251, 32286, 32319, 32352, 32383, 32413, 32442, 32470, 32496, 32522, 32546, 32568, 32590,
+    32610, 32629, 32647, 32664, 32679, 32693, 32706, 32718, 32729, 32738, 32746, 32753, 32758, 32762, 32766, 32767,
+    32768
+};
+
+/**
+ * Sine from a 257 entry quarter wave table with linear interpolation, error within 2 LSB
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param angle binary angle, only the low 16 bits are used
+ * @return sine in Q15, -32768 to 32768
+ */
+int32_t fix_sin(int32_t angle){
+    uint32_t a = angle & 0xFFFF;
+    uint32_t i, frac;
+    int32_t s;
+    if(a & 0x4000)//second and fourth quarters run the table backwards
+        a = 0x4000 - (a & 0x3FFF);
+    else
+        a &= 0x3FFF;
+    i = a >> 6;//table index, 0 to 256
+    frac = a & 0x3F;//interpolation, 6 bits
+    if(i == 256)
+        s = fix_sinTable[256];
+    else
+        s = fix_sinTable[i] + (((fix_sinTable[i+1] - fix_sinTable[i]) * frac) >> 6);
+    return (angle & 0x8000) ? -s : s;
+}
+/**
+ * Cosine, fix_sin a quarter turn ahead
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param angle binary angle, only the low 16 bits are used
+ * @return cosine in Q15, -32768 to 32768
+ */
+int32_t fix_cos(int32_t angle){
+    return fix_sin(angle + 0x4000);
+}
+/**
+ * Angle of a vector, polynomial approximation good to about 0.1 degree
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param y vector y component, any scale
+ * @param x vector x component, same scale as y
+ * @return binary angle from +x, -32768 to 32768, 0 for a zero vector
+ */
+int32_t fix_atan2(int32_t y, int32_t x){
+    uint32_t ax = x < 0 ? -x : x, ay = y < 0 ? -y : y;
+    uint32_t hi = ax > ay ? ax : ay, lo = ax > ay ? ay : ax;
+    int32_t z, w, a;
+    if(hi == 0)
+        return 0;
+    while(hi > 0xFFFF){//keep lo << 15 in 32 bits
+        hi >>= 1;
+        lo >>= 1;
+    }
+    z = (lo << 15) / hi;//tangent of the first octant angle, Q15 0 to 1
+    //atan(z) = pi/4 z + z(1-z)(0.2447 + 0.0663 z) radians, scaled to binary angles
+    w = (z * (32768 - z)) >> 15;
+    a = (z >> 2) + ((w * (2552 + ((692 * z) >> 15))) >> 15);
+    if(ay > ax)
+        a = 0x4000 - a;
+    if(x < 0)
+        a = 0x8000 - a;
+    if(y < 0)
+        a = -a;
+    return a;
+}
+/**
+ * Integer square root
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x value
+ * @return largest integer whose square is at most x
+ */
+uint32_t fix_isqrt(uint32_t x){
+    uint32_t root = 0, bit = 1UL << 30;
+    while(bit > x)
+        bit >>= 2;
+    while(bit){//one result bit per pass, no multiply or divide
+        if(x >= root + bit){
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        } else
+            root >>= 1;
+        bit >>= 2;
+    }
+    return root;
+}
+/**
+ * Measure cycles per call and worst error of each kernel against the double precision library, reported over uart
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void fix_bench(void){
+    char s[80];
+    volatile int32_t sinkI = 0;//keeps the timed calls from being optimized out
+    volatile double sinkD = 0;
+    uint32_t start, fixCycles, libCycles;
+    double err, worst;
+    int32_t n;
+
+    bench_init();
+
+    //sin, one call per degree
+    start = bench_cycles();
+    for(n = 0; n < 360; n++)
+        sinkI += fix_sin(FIX_DEG(n));
+    fixCycles = (bench_cycles() - start) / 360;
+    start = bench_cycles();
+    for(n = 0; n < 360; n++)
+        sinkD += sin(n * 0.017453292519943);
+    libCycles = (bench_cycles() - start) / 360;
+    worst = 0;
+    for(n = 0; n < FIX_TURN; n += 7){
+        err = fabs(fix_sin(n) / 32768.0 - sin(n * 6.283185307179586 / FIX_TURN));
+        if(err > worst)
+            worst = err;
+    }
+    sprintf(s, "\r\nsin\tfix %d cycles\tlibm %d cycles\terror %.6lf", (int)fixCycles, (int)libCycles, worst);
+    uart_sendStr(s);
+
+    //atan2, vectors around a circle of radius 1000
+    start = bench_cycles();
+    for(n = 0; n < 360; n++)
+        sinkI += fix_atan2(n - 180, 1000 - n);
+    fixCycles = (bench_cycles() - start) / 360;
+    start = bench_cycles();
+    for(n = 0; n < 360; n++)
+        sinkD += atan2(n - 180, 1000 - n);
+    libCycles = (bench_cycles() - start) / 360;
+    worst = 0;
+    for(n = 0; n < 3600; n++){
+        int32_t x = fix_cos(FIX_DEG(n) / 10) >> 5, y = fix_sin(FIX_DEG(n) / 10) >> 5;
+        err = fabs(fix_atan2(y, x) * 360.0 / FIX_TURN - atan2(y, x) * 57.29577951308232);
+        if(err > 180)
+            err = 360 - err;//+-180 are the same angle
+        if(err > worst)
+            worst = err;
+    }
+    sprintf(s, "\r\natan2\tfix %d cycles\tlibm %d cycles\terror %.3lf deg", (int)fixCycles, (int)libCycles, worst);
+    uart_sendStr(s);
+
+    //sqrt, distances up to about 2 m squared in cm
+    start = bench_cycles();
+    for(n = 0; n < 360; n++)
+        sinkI += fix_isqrt(n * 111);
+    fixCycles = (bench_cycles() - start) / 360;
+    start = bench_cycles();
+    for(n = 0; n < 360; n++)
+        sinkD += sqrt(n * 111);
+    libCycles = (bench_cycles() - start) / 360;
+    worst = 0;
+    for(n = 0; n < 40000; n += 3){
+        err = sqrt(n) - fix_isqrt(n);//floor, so always 0 to 1
+        if(err > worst)
+            worst = err;
+    }
+    sprintf(s, "\r\nsqrt\tfix %d cycles\tlibm %d cycles\terror %.3lf", (int)fixCycles, (int)libCycles, worst);
+    uart_sendStr(s);
+}
@@ -0,0 +1,59 @@
+/**
+ * @file fixmath.h
+ * @brief fixed point sin, cos, atan2 and square root for the map and position geometry, no soft float
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+
+#ifndef FIXMATH_H_
+#define FIXMATH_H_
+
+#include <stdint.h>
+
+//angles are binary angles, 65536 per turn, so they wrap for free in 16 bits
+#define FIX_TURN 65536
+#define FIX_DEG(d) ((int32_t)((d)*65536L/360)) //degrees to a binary angle, pass an int for no float math
+#define FIX_ONE 32768 //1.0 in Q15, what fix_sin and fix_cos return at the peaks
+#define FIX_RAD_Q16 1144 //pi/180 in Q16, degrees*radius*FIX_RAD_Q16 >> 16 is arc length
+
+/**
+ * Sine from a 257 entry quarter wave table with linear interpolation, error within 2 LSB
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param angle binary angle, only the low 16 bits are used
+ * @return sine in Q15, -32768 to 32768
+ */
+int32_t fix_sin(int32_t angle);
+/**
+ * Cosine, fix_sin a quarter turn ahead
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param angle binary angle, only the low 16 bits are used
+ * @return cosine in Q15, -32768 to 32768
+ */
+int32_t fix_cos(int32_t angle);
+/**
+ * Angle of a vector, polynomial approximation good to about 0.1 degree
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param y vector y component, any scale
+ * @param x vector x component, same scale as y
+ * @return binary angle from +x, -32768 to 32768, 0 for a zero vector
+ */
+int32_t fix_atan2(int32_t y, int32_t x);
+/**
+ * Integer square root
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x value
+ * @return largest integer whose square is at most x
+ */
+uint32_t fix_isqrt(uint32_t x);
+/**
+ * Measure cycles per call and worst error of each kernel against the double precision library, reported over uart
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void fix_bench(void);
+
+#endif /* FIXMATH_H_ */
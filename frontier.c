@@ -0,0 +1,247 @@
+/**
+ * @file frontier.c
+ * @brief frontier cells, free cells next to unexplored ones, kept up to date tile by tile and grouped into ranked targets
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+#include "frontier.h"
+#include "fixmath.h"
+#include "stdlib.h"
+
+uint16_t frontier_bits[GRID_TILES][GRID_TILE];
+frontier_t frontiers[FRONTIER_MAX];
+int frontier_count = 0;
+
+/**
+ * Cells of one tile row that have a value, as a bit mask
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param t tile, 0 for a tile never written, which is all unexplored
+ * @param row row in the tile
+ * @param v cell value
+ * @return bit x set if cell x of the row is v
+ */
+uint16_t frontier_rowMask(const grid_tile_t *t, int row, uint8_t v){
+    uint16_t mask = 0;
+    int x;
+    if(!t)
+        return v == GRID_UNEXPLORED ? 0xFFFF : 0;
+    for(x = 0; x < GRID_TILE; x += 2){//both cells of a byte at once
+        if((t->cells[row][x >> 1] & 0xF) == v)
+            mask |= 1 << x;
+        if((t->cells[row][x >> 1] >> 4) == v)
+            mask |= 2 << x;
+    }
+    return mask;
+}
+/**
+ * Find the frontier cells of a tile, free cells with an unexplored cell above, below, left or right of them
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param n position of the tile in the pool
+ */
+void frontier_tile(int n){
+    grid_tile_t *t = &grid_tiles[n];
+    const grid_tile_t *above, *below;
+    int x0 = t->tx << GRID_TILE_SHIFT, y0 = t->ty << GRID_TILE_SHIFT, row;
+    uint16_t free, unex, prev, next, side;
+    below = grid_tile(x0, y0 - 1, 0);//tile pointers stay valid, nothing is allocated here
+    above = grid_tile(x0, y0 + GRID_TILE, 0);
+    //a missing tile is all unexplored unless it was evicted, then it is free
+    prev = below || !grid_wasFree(x0, y0 - 1) ? frontier_rowMask(below, GRID_TILE - 1, GRID_UNEXPLORED) : 0;
+    unex = frontier_rowMask(t, 0, GRID_UNEXPLORED);
+    for(row = 0; row < GRID_TILE; row++){
+        if(row + 1 < GRID_TILE)
+            next = frontier_rowMask(t, row + 1, GRID_UNEXPLORED);
+        else
+            next = above || !grid_wasFree(x0, y0 + GRID_TILE) ? frontier_rowMask(above, 0, GRID_UNEXPLORED) : 0;
+        free = frontier_rowMask(t, row, GRID_FREE);
+        side = (unex << 1) | (unex >> 1);
+        if(grid_get(x0 - 1, y0 + row) == GRID_UNEXPLORED)
+            side |= 1;
+        if(grid_get(x0 + GRID_TILE, y0 + row) == GRID_UNEXPLORED)
+            side |= 1 << (GRID_TILE - 1);
+        frontier_bits[n][row] = free & (side | prev | next);
+        prev = unex;
+        unex = next;
+    }
+    t->changed = 0;
+}
+/**
+ * Check if a cell touches a cluster's bounding box
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param f cluster
+ * @param x cell column
+ * @param y cell row
+ * @return 1 if the cell is in or next to the box
+ */
+static inline int frontier_touches(const frontier_t *f, int x, int y){
+    return x >= f->minX - 1 && x <= f->maxX + 1 && y >= f->minY - 1 && y <= f->maxY + 1;
+}
+/**
+ * Add a cell to a cluster
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param f cluster
+ * @param x cell column
+ * @param y cell row
+ */
+void frontier_add(frontier_t *f, int x, int y){
+    if(!f->size){
+        f->minX = f->maxX = x;
+        f->minY = f->maxY = y;
+    }
+    if(x < f->minX) f->minX = x;
+    if(x > f->maxX) f->maxX = x;
+    if(y < f->minY) f->minY = y;
+    if(y > f->maxY) f->maxY = y;
+    f->size++;
+    f->sumX += x;
+    f->sumY += y;
+}
+/**
+ * Merge clusters whose bounding boxes touch, cells added in row order can start separate clusters that later join
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void frontier_merge(void){
+    int i, j;
+    frontier_t *a, *b;
+    for(i = 0; i < frontier_count; i++){
+        for(j = i + 1; j < frontier_count; j++){
+            a = &frontiers[i];
+            b = &frontiers[j];
+            if(b->minX > a->maxX + 1 || b->maxX < a->minX - 1 || b->minY > a->maxY + 1 || b->maxY < a->minY - 1)
+                continue;
+            if(b->minX < a->minX) a->minX = b->minX;
+            if(b->maxX > a->maxX) a->maxX = b->maxX;
+            if(b->minY < a->minY) a->minY = b->minY;
+            if(b->maxY > a->maxY) a->maxY = b->maxY;
+            a->size += b->size;
+            a->sumX += b->sumX;
+            a->sumY += b->sumY;
+            frontiers[j] = frontiers[--frontier_count];
+            j = i;//a grew, check everything after it again
+        }
+    }
+}
+/**
+ * Group the frontier cells of every tile into clusters
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void frontier_cluster(void){
+    int n, row, bit, x, y, i, best, d, bestD;
+    uint16_t bits;
+    frontier_count = 0;
+    for(n = 0; n < GRID_TILES; n++){
+        if(!grid_tiles[n].used)
+            continue;
+        for(row = 0; row < GRID_TILE; row++){
+            for(bits = frontier_bits[n][row], bit = 0; bits; bits >>= 1, bit++){
+                if(!(bits & 1))
+                    continue;
+                x = (grid_tiles[n].tx << GRID_TILE_SHIFT) + bit;
+                y = (grid_tiles[n].ty << GRID_TILE_SHIFT) + row;
+                best = -1;
+                bestD = 0x7FFF;
+                for(i = 0; i < frontier_count; i++){
+                    if(frontier_touches(&frontiers[i], x, y)){
+                        best = i;
+                        break;
+                    }
+                    //no room for another cluster, it will join the closest one
+                    d = abs(x - frontiers[i].sumX/frontiers[i].size) + abs(y - frontiers[i].sumY/frontiers[i].size);
+                    if(d < bestD){
+                        bestD = d;
+                        if(frontier_count == FRONTIER_MAX)
+                            best = i;
+                    }
+                }
+                if(best < 0){
+                    best = frontier_count++;
+                    frontiers[best].size = 0;
+                    frontiers[best].sumX = 0;
+                    frontiers[best].sumY = 0;
+                }
+                frontier_add(&frontiers[best], x, y);
+            }
+        }
+        frontier_merge();
+    }
+}
+/**
+ * Pick the member cell nearest the middle of each cluster as its target and rank them
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x cybot cell column
+ * @param y cybot cell row
+ */
+void frontier_rank(int x, int y){
+    int n, row, bit, cx, cy, i, d;
+    int16_t nearest[FRONTIER_MAX];
+    uint16_t bits;
+    frontier_t f;
+    for(i = 0; i < frontier_count; i++)
+        nearest[i] = 0x7FFF;
+    for(n = 0; n < GRID_TILES; n++){
+        if(!grid_tiles[n].used)
+            continue;
+        for(row = 0; row < GRID_TILE; row++){
+            for(bits = frontier_bits[n][row], bit = 0; bits; bits >>= 1, bit++){
+                if(!(bits & 1))
+                    continue;
+                cx = (grid_tiles[n].tx << GRID_TILE_SHIFT) + bit;
+                cy = (grid_tiles[n].ty << GRID_TILE_SHIFT) + row;
+                for(i = 0; i < frontier_count; i++){
+                    if(cx < frontiers[i].minX || cx > frontiers[i].maxX || cy < frontiers[i].minY || cy > frontiers[i].maxY)
+                        continue;
+                    d = abs(cx - frontiers[i].sumX/frontiers[i].size) + abs(cy - frontiers[i].sumY/frontiers[i].size);
+                    if(d < nearest[i]){
+                        nearest[i] = d;
+                        frontiers[i].x = cx;
+                        frontiers[i].y = cy;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+    //drop noise, then insertion sort by size against distance, there are at most FRONTIER_MAX
+    for(i = 0; i < frontier_count; ){
+        if(frontiers[i].size < FRONTIER_MIN_SIZE){
+            frontiers[i] = frontiers[--frontier_count];
+            continue;
+        }
+        frontiers[i].dist = fix_isqrt((frontiers[i].x - x)*(frontiers[i].x - x) + (frontiers[i].y - y)*(frontiers[i].y - y));
+        i++;
+    }
+    for(n = 1; n < frontier_count; n++){
+        f = frontiers[n];
+        d = f.size*FRONTIER_SIZE_WEIGHT - f.dist;
+        for(i = n; i > 0 && frontiers[i-1].size*FRONTIER_SIZE_WEIGHT - frontiers[i-1].dist < d; i--)
+            frontiers[i] = frontiers[i-1];
+        frontiers[i] = f;
+    }
+}
+/**
+ * Recheck the tiles whose cells changed since the last update, then regroup and rank the frontier cells
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x cybot cell column
+ * @param y cybot cell row
+ * @return number of tiles rechecked
+ */
+int frontier_update(int x, int y){
+    int n, checked = 0;
+    for(n = 0; n < GRID_TILES; n++){
+        if(grid_tiles[n].used && grid_tiles[n].changed){
+            frontier_tile(n);
+            checked++;
+        }
+    }
+    frontier_cluster();
+    frontier_rank(x, y);
+    return checked;
+}
@@ -0,0 +1,50 @@
+/**
+ * @file frontier.h
+ * @brief frontier cells, free cells next to unexplored ones, kept up to date tile by tile and grouped into ranked targets
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+
+#ifndef FRONTIER_H_
+#define FRONTIER_H_
+
+#include <stdint.h>
+#include "grid.h"
+
+#define FRONTIER_MAX 16 //clusters kept, further ones are merged into the nearest
+#define FRONTIER_MIN_SIZE 2 //smaller clusters are sensor noise and not reported
+#define FRONTIER_SIZE_WEIGHT 4 //cells of travel one frontier cell is worth when ranking
+
+/// A group of touching frontier cells
+typedef struct {
+    int16_t x, y;      //member cell nearest the middle of the group, a free cell to drive to
+    uint16_t size;     //frontier cells in the group
+    uint16_t dist;     //cells from the cybot to x,y in a straight line
+    int16_t minX, minY, maxX, maxY; //bounding box
+    int32_t sumX, sumY; //for the middle
+} frontier_t;
+
+extern uint16_t frontier_bits[GRID_TILES][GRID_TILE]; //frontier cells of each pool tile, one bit per cell in each row
+extern frontier_t frontiers[FRONTIER_MAX]; //best first
+extern int frontier_count;
+
+/**
+ * Recheck the tiles whose cells changed since the last update, then regroup and rank the frontier cells
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x cybot cell column
+ * @param y cybot cell row
+ * @return number of tiles rechecked
+ */
+int frontier_update(int x, int y);
+/**
+ * Best frontier to explore from the last update, nearby and large first
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return best frontier, 0 if the whole reachable area is explored
+ */
+static inline const frontier_t *frontier_best(void){
+    return frontier_count ? &frontiers[0] : 0;
+}
+
+#endif /* FRONTIER_H_ */
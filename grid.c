@@ -0,0 +1,335 @@
+/**
+ * @file grid.c
+ * @brief sparse tiled occupancy grid, 4-bit cells in fixed size tiles allocated from a static pool the first time they are written
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+#include "grid.h"
+#include <string.h>
+#include <stdio.h>
+
+grid_tile_t grid_tiles[GRID_TILES];
+grid_tile_t *grid_last = 0; //last tile found, checked before the index
+uint8_t grid_index[GRID_INDEX_SIZE]; //open addressed hash of tile coordinates, pool position + 1, 0 if empty
+uint32_t grid_clock = 0; //counts tile uses for grid_tile_t stamp
+uint32_t grid_evictions = 0;
+uint32_t grid_dropped = 0;
+//tile coordinates of evicted tiles as 0x8000 | ty << 8 | tx, 0 if empty, the oldest is forgotten first
+uint16_t grid_forgotten[GRID_FORGOTTEN];
+int grid_forgottenNext = 0;
+//map character for each cell value, unused values render as '?'
+const char grid_symbols[16] = {'#', ' ', 'B', 'C', 'G', 'L', '?', '?', '?', '?', '?', '?', '?', '?', '?', '?'};
+
+/**
+ * First index slot to probe for a tile
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param tx tile column
+ * @param ty tile row
+ * @return index slot
+ */
+static inline int grid_hash(int tx, int ty){
+    return (tx * 13 + ty) & (GRID_INDEX_SIZE - 1);
+}
+/**
+ * Add a tile to the index
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param n position of the tile in the pool
+ */
+void grid_indexAdd(int n){
+    int i = grid_hash(grid_tiles[n].tx, grid_tiles[n].ty);
+    while(grid_index[i])
+        i = (i + 1) & (GRID_INDEX_SIZE - 1);
+    grid_index[i] = n + 1;
+}
+/**
+ * Find an evicted tile in the list
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param tx tile column
+ * @param ty tile row
+ * @return position in grid_forgotten, -1 if not there
+ */
+int grid_findForgotten(int tx, int ty){
+    uint16_t key = 0x8000 | ty << 8 | tx;
+    int i;
+    for(i = 0; i < GRID_FORGOTTEN; i++)
+        if(grid_forgotten[i] == key)
+            return i;
+    return -1;
+}
+/**
+ * Check if a cell is in a tile that was evicted with every cell free, so it reads as free
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x cell column
+ * @param y cell row
+ * @return 1 if the tile is one of the last GRID_FORGOTTEN evicted
+ */
+int grid_wasFree(int x, int y){
+    return grid_inBounds(x, y) && grid_findForgotten(x >> GRID_TILE_SHIFT, y >> GRID_TILE_SHIFT) >= 0;
+}
+/**
+ * Flag the tile holding a cell as changed without allocating it
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x cell column
+ * @param y cell row
+ */
+void grid_touch(int x, int y){
+    grid_tile_t *t = grid_tile(x, y, 0);
+    if(t)
+        t->changed = 1;
+}
+/**
+ * Flag the tiles beside a tile as changed, their edge cells border it
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param tx tile column
+ * @param ty tile row
+ */
+void grid_touchAround(int tx, int ty){
+    int x = tx << GRID_TILE_SHIFT, y = ty << GRID_TILE_SHIFT;
+    grid_touch(x - 1, y);
+    grid_touch(x + GRID_TILE, y);
+    grid_touch(x, y - 1);
+    grid_touch(x, y + GRID_TILE);
+}
+/**
+ * Check if every cell of a tile has been explored
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param t tile
+ * @return 1 if no cell is GRID_UNEXPLORED
+ */
+int grid_explored(const grid_tile_t *t){
+    const uint8_t *cell = &t->cells[0][0];
+    int n;
+    for(n = 0; n < (int)sizeof(t->cells); n++)
+        if(!(cell[n] & 0xF) || !(cell[n] >> 4))
+            return 0;
+    return 1;
+}
+/**
+ * Take a tile for a new part of the world, a free one if there is one, otherwise the least recently used tile without
+ * objects or hazards, fully explored tiles first, those are all free cells and are remembered as free space until
+ * GRID_FORGOTTEN more have been evicted, a tile that still had unexplored cells is forgotten outright
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return position in the pool, -1 if every tile holds objects or hazards
+ */
+int grid_alloc(void){
+    int n, best = -1, bestExplored = 0, explored;
+    uint16_t old;
+    for(n = 0; n < GRID_TILES; n++){
+        if(!grid_tiles[n].used)
+            return n;
+        if(grid_tiles[n].keep)
+            continue;
+        explored = grid_explored(&grid_tiles[n]);
+        if(best < 0 || explored > bestExplored ||
+           (explored == bestExplored && (int32_t)(grid_tiles[n].stamp - grid_tiles[best].stamp) < 0)){
+            best = n;
+            bestExplored = explored;
+        }
+    }
+    if(best < 0)
+        return -1;
+    grid_evictions++;
+    grid_tiles[best].used = 0;
+    grid_last = 0;
+    //linear probing can't just clear one slot, rebuild the index without the evicted tile, evictions are rare
+    memset(grid_index, 0, sizeof(grid_index));
+    for(n = 0; n < GRID_TILES; n++)
+        if(grid_tiles[n].used)
+            grid_indexAdd(n);
+    if(!bestExplored){//not remembered, its cells read unexplored again and the edges of its neighbours may be frontiers
+        grid_touchAround(grid_tiles[best].tx, grid_tiles[best].ty);
+        return best;
+    }
+    old = grid_forgotten[grid_forgottenNext];
+    grid_forgotten[grid_forgottenNext] = 0x8000 | grid_tiles[best].ty << 8 | grid_tiles[best].tx;
+    grid_forgottenNext = (grid_forgottenNext + 1) % GRID_FORGOTTEN;
+    //the oldest evicted tile is unexplored again, so edge cells of its neighbours may be frontiers
+    if(old)
+        grid_touchAround(old & 0xFF, (old >> 8) & 0x7F);
+    return best;
+}
+/**
+ * Find the tile holding a cell through the tile index, allocating it if asked, use grid_tile
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x cell column
+ * @param y cell row
+ * @param create 1 to allocate the tile if it does not exist yet
+ * @return tile, 0 if it does not exist or could not be allocated
+ */
+grid_tile_t *grid_lookup(int x, int y, int create){
+    int tx = x >> GRID_TILE_SHIFT, ty = y >> GRID_TILE_SHIFT, i, n;
+    grid_tile_t *t;
+    if(!grid_inBounds(x, y))
+        return 0;
+    for(i = grid_hash(tx, ty); grid_index[i]; i = (i + 1) & (GRID_INDEX_SIZE - 1)){
+        t = &grid_tiles[grid_index[i] - 1];
+        if(t->tx == tx && t->ty == ty){
+            t->stamp = ++grid_clock;
+            grid_last = t;
+            return t;
+        }
+    }
+    if(!create)
+        return 0;
+    n = grid_alloc();
+    if(n < 0){
+        grid_dropped++;
+        return 0;
+    }
+    t = &grid_tiles[n];
+    memset(t, 0, sizeof(*t));//all cells unexplored with 0 log-odds
+    if((i = grid_findForgotten(tx, ty)) >= 0){//back to a tile that was evicted fully explored and free
+        memset(t->cells, GRID_FREE << 4 | GRID_FREE, sizeof(t->cells));
+        grid_forgotten[i] = 0;
+    }
+    t->tx = tx;
+    t->ty = ty;
+    t->used = 1;
+    t->changed = 1;
+    t->stamp = ++grid_clock;
+    grid_indexAdd(n);
+    grid_last = t;
+    return t;
+}
+/**
+ * Write a cell and mark its row dirty if it changed, allocates its tile, ignored if off the world
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x cell column
+ * @param y cell row
+ * @param v cell value
+ */
+void grid_set(int x, int y, uint8_t v){
+    grid_tile_t *t = grid_tile(x, y, v != GRID_UNEXPLORED);//unexplored is what a missing tile reads as anyway
+    uint8_t *cell, old;
+    int shift = (x & 1) << 2;
+    if(!t)
+        return;
+    cell = &t->cells[y & GRID_TILE_MASK][(x & GRID_TILE_MASK) >> 1];
+    old = (*cell >> shift) & 0xF;
+    v &= 0xF;
+    if(old == v)
+        return;
+    *cell = (*cell & ~(0xF << shift)) | (v << shift);
+    t->keep += (v > GRID_FREE) - (old > GRID_FREE);
+    t->dirty |= 1 << (y & GRID_TILE_MASK);
+    t->changed = 1;
+    //frontier cells next to this one may be in the neighbouring tile
+    if((x & GRID_TILE_MASK) == 0)
+        grid_touch(x - 1, y);
+    if((x & GRID_TILE_MASK) == GRID_TILE_MASK)
+        grid_touch(x + 1, y);
+    if((y & GRID_TILE_MASK) == 0)
+        grid_touch(x, y - 1);
+    if((y & GRID_TILE_MASK) == GRID_TILE_MASK)
+        grid_touch(x, y + 1);
+}
+/**
+ * Free every tile, the whole world is unexplored again
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void grid_clear(void){
+    int n;
+    for(n = 0; n < GRID_TILES; n++)
+        grid_tiles[n].used = 0;
+    memset(grid_index, 0, sizeof(grid_index));
+    memset(grid_forgotten, 0, sizeof(grid_forgotten));
+    grid_last = 0;
+}
+/**
+ * Number of tiles allocated
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return tiles in use out of GRID_TILES
+ */
+int grid_tilesUsed(void){
+    int n, used = 0;
+    for(n = 0; n < GRID_TILES; n++)
+        used += grid_tiles[n].used;
+    return used;
+}
+/**
+ * Find the next tile with rows changed since they were last encoded
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param n first tile in the pool to check
+ * @return dirty tile at or after n, -1 if there are none
+ */
+int grid_nextDirty(int n){
+    if(n < 0)
+        n = 0;
+    for(; n < GRID_TILES; n++)
+        if(grid_tiles[n].used && grid_tiles[n].dirty)
+            return n;
+    return -1;
+}
+/**
+ * Mark every row of every tile dirty so the next update resends the whole grid
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void grid_markAllDirty(void){
+    int n;
+    for(n = 0; n < GRID_TILES; n++)
+        grid_tiles[n].dirty = 0xFFFF;
+}
+/**
+ * Encode the first dirty row of a tile as a run length map update message and mark it clean
+ * Format is "$M<y>,<x>,<runs>\r\n" for the GRID_TILE cells starting at column x, each run is a map character followed by
+ * its length in decimal if longer than 1, map characters are never digits so the runs parse unambiguously, e.g. "$M1030,1024,#3B2 11"
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param n tile from grid_nextDirty
+ * @param line buffer of at least GRID_RLE_SIZE characters, not null terminated
+ * @return number of characters encoded, 0 if the tile has no dirty rows
+ */
+int grid_encodeRow(int n, char *line){
+    grid_tile_t *t = &grid_tiles[n];
+    int x = 0, row = 0, run, len;
+    uint8_t v;
+    if(!t->dirty)
+        return 0;
+    while(!(t->dirty & (1 << row)))
+        row++;
+    len = sprintf(line, "$M%d,%d,", (t->ty << GRID_TILE_SHIFT) + row, t->tx << GRID_TILE_SHIFT);
+    while(x < GRID_TILE){
+        v = (t->cells[row][x >> 1] >> ((x & 1) << 2)) & 0xF;
+        run = 1;
+        while(x + run < GRID_TILE && ((t->cells[row][(x + run) >> 1] >> (((x + run) & 1) << 2)) & 0xF) == v)
+            run++;
+        line[len++] = grid_symbols[v];
+        if(run > 1)
+            len += sprintf(line + len, "%d", run);
+        x += run;
+    }
+    line[len++] = '\r';
+    line[len++] = '\n';
+    t->dirty &= ~(1 << row);
+    return len;
+}
+/**
+ * Render part of a row as the map characters used by draw_map
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x first cell column
+ * @param y row
+ * @param len number of cells
+ * @param line buffer of at least len characters, not null terminated
+ * @return number of characters rendered, always len
+ */
+int grid_renderRow(int x, int y, int len, char *line){
+    int n;
+    for(n = 0; n < len; n++)
+        line[n] = grid_symbols[grid_get(x + n, y)];//the tile cache makes this one index lookup per tile
+    return len;
+}
@@ -0,0 +1,188 @@
+/**
+ * @file grid.h
+ * @brief sparse tiled occupancy grid, 4-bit cells in fixed size tiles allocated from a static pool the first time they are written
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+
+#ifndef GRID_H_
+#define GRID_H_
+
+#include <stdint.h>
+
+#define GRID_SIZE 2048 //cells along each side of the world, 1 dm each, tile coordinates fit in a byte
+#define GRID_ORIGIN (GRID_SIZE / 2) //start cell on both axes, so cell coordinates never go negative
+#define GRID_TILE_SHIFT 4
+#define GRID_TILE (1 << GRID_TILE_SHIFT) //cells along each side of a tile
+#define GRID_TILE_MASK (GRID_TILE - 1)
+//tile pool, about 400 bytes each, the biggest user of the 32 KB of SRAM, 32 tiles hold 8192 cells and an arena that
+//doesn't line up with the tiles can touch 7x7 of them, past that the least recently used tile without objects or
+//hazards is evicted, fully explored ones first, a tile that still had unexplored cells is simply unexplored again
+//RAM budget: about 26.9 KB of .bss and .data plus what the last CCS link map (Debug/projecto finalo.map) shows the rest
+//takes, 620 byte vtable, 2 KB stack, 1 KB heap and 24 bytes of library data, leaves about 2 KB free, check the .map
+//after growing any static buffer
+#define GRID_TILES 32
+#define GRID_INDEX_SIZE 128 //tile index hash slots, power of 2 at least twice GRID_TILES
+#define GRID_FORGOTTEN 48 //fully explored evicted tiles remembered as free space so frontiers don't send the cybot back to them
+#define GRID_WIDTH 94 //cells along x of the window draw_map renders around the cybot
+#define GRID_HEIGHT 94 //cells along y of that window
+#define GRID_RLE_SIZE (GRID_TILE + 16) //longest grid_encodeRow line, runs never take more characters than cells
+
+//cell values, 4 bits each
+#define GRID_UNEXPLORED 0 //'#'
+#define GRID_FREE 1 //' '
+#define GRID_OBJECT 2 //'B'
+#define GRID_CLIFF 3 //'C'
+#define GRID_EDGE 4 //'G'
+#define GRID_BUMP 5 //'L'
+
+/// One square of the world, cells are packed two per byte with even x in the low nibble
+typedef struct {
+    uint8_t tx, ty;  //tile coordinates, cell coordinates >> GRID_TILE_SHIFT
+    uint16_t keep;   //cells that are not free or unexplored, tiles with none can be evicted
+    uint16_t dirty;  //rows changed since they were last encoded, one bit per row
+    uint8_t used;    //1 if allocated
+    uint8_t changed; //cells here or on the edge of a neighbour changed since frontier_update last looked
+    uint32_t stamp;  //grid_clock when last used, oldest is evicted first
+    uint8_t cells[GRID_TILE][GRID_TILE / 2];
+    int8_t occ[GRID_TILE][GRID_TILE]; //log-odds layer, see occupancy.h
+} grid_tile_t;
+
+extern grid_tile_t grid_tiles[GRID_TILES];
+extern grid_tile_t *grid_last;
+extern const char grid_symbols[16];
+extern uint32_t grid_evictions; //tiles reused for another part of the world
+extern uint32_t grid_dropped; //writes lost because every tile held objects or hazards
+
+/**
+ * Check if a cell is in a tile that was evicted with every cell free, so it reads as free
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x cell column
+ * @param y cell row
+ * @return 1 if the tile is one of the last GRID_FORGOTTEN evicted
+ */
+int grid_wasFree(int x, int y);
+
+/**
+ * Check if a cell is in the world
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x cell column
+ * @param y cell row
+ * @return 1 if the cell exists
+ */
+static inline int grid_inBounds(int x, int y){
+    return x >= 0 && x < GRID_SIZE && y >= 0 && y < GRID_SIZE;
+}
+/**
+ * Find the tile holding a cell through the tile index, allocating it if asked, use grid_tile
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x cell column
+ * @param y cell row
+ * @param create 1 to allocate the tile if it does not exist yet
+ * @return tile, 0 if it does not exist or could not be allocated
+ */
+grid_tile_t *grid_lookup(int x, int y, int create);
+/**
+ * Find the tile holding a cell, neighbouring cells are usually in the last tile used so that is checked first
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x cell column
+ * @param y cell row
+ * @param create 1 to allocate the tile if it does not exist yet
+ * @return tile, 0 if the cell is off the world, the tile does not exist or it could not be allocated
+ */
+static inline grid_tile_t *grid_tile(int x, int y, int create){
+    grid_tile_t *t = grid_last;
+    if(t && t->tx == (x >> GRID_TILE_SHIFT) && t->ty == (y >> GRID_TILE_SHIFT))//cells off the world never match a tile
+        return t;
+    return grid_lookup(x, y, create);
+}
+/**
+ * Read a cell, cells off the world or in tiles never written are unexplored, cells in tiles evicted are free
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x cell column
+ * @param y cell row
+ * @return cell value
+ */
+static inline uint8_t grid_get(int x, int y){
+    grid_tile_t *t = grid_tile(x, y, 0);
+    if(!t)
+        return grid_wasFree(x, y) ? GRID_FREE : GRID_UNEXPLORED;
+    return (t->cells[y & GRID_TILE_MASK][(x & GRID_TILE_MASK) >> 1] >> ((x & 1) << 2)) & 0xF;
+}
+/**
+ * Write a cell and mark its row dirty if it changed, allocates its tile, ignored if off the world
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x cell column
+ * @param y cell row
+ * @param v cell value
+ */
+void grid_set(int x, int y, uint8_t v);
+/**
+ * Write a cell if it is in the world, same as grid_set
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x cell column
+ * @param y cell row
+ * @param v cell value
+ */
+static inline void grid_mark(int x, int y, uint8_t v){
+    grid_set(x, y, v);
+}
+
+/**
+ * Free every tile, the whole world is unexplored again
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void grid_clear(void);
+/**
+ * Number of tiles allocated
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return tiles in use out of GRID_TILES
+ */
+int grid_tilesUsed(void);
+/**
+ * Find the next tile with rows changed since they were last encoded
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param n first tile in the pool to check
+ * @return dirty tile at or after n, -1 if there are none
+ */
+int grid_nextDirty(int n);
+/**
+ * Mark every row of every tile dirty so the next update resends the whole grid
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void grid_markAllDirty(void);
+/**
+ * Encode the first dirty row of a tile as a run length map update message and mark it clean
+ * Format is "$M<y>,<x>,<runs>\r\n" for the GRID_TILE cells starting at column x, each run is a map character followed by
+ * its length in decimal if longer than 1, map characters are never digits so the runs parse unambiguously, e.g. "$M1030,1024,#3B2 11"
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param n tile from grid_nextDirty
+ * @param line buffer of at least GRID_RLE_SIZE characters, not null terminated
+ * @return number of characters encoded, 0 if the tile has no dirty rows
+ */
+int grid_encodeRow(int n, char *line);
+/**
+ * Render part of a row as the map characters used by draw_map
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x first cell column
+ * @param y row
+ * @param len number of cells
+ * @param line buffer of at least len characters, not null terminated
+ * @return number of characters rendered, always len
+ */
+int grid_renderRow(int x, int y, int len, char *line);
+
+#endif /* GRID_H_ */
@@ -15,33 +15,42 @@
 #include "servo.h"
 #include "ping.h"
 #include "button.h"
+#include <stdint.h>
+#include "driverlib/interrupt.h"
 
-#define CALI 38647//15077(8)//50327
+int ir_cali = 38647;//15077(8)//50327, replaced at boot by a calibration saved in the EEPROM
 //(#,CALI): (9,43681) (11,31770)
 //cali must be calibrated for accurate use
 //currently calibrated for cybot 8
+#define IR_BUFFER_SIZE 32 //power of 2
+#define IR_SAMPLE_PERIOD 1000 //default time between samples in us
+
+typedef struct {
+    uint32_t time; //timer_now when the conversion finished
+    short value;
+} ir_sample_t;
+
+volatile ir_sample_t ir_samples[IR_BUFFER_SIZE];
+volatile uint32_t ir_count = 0; //samples taken since sampling started, newest is ir_samples[(ir_count-1)%IR_BUFFER_SIZE]
+int ir_sampling = 0;
 /**
- * This method is designed to automatically handle ADC interrupts but it is currently disabled and unused
+ * ADC0 SS0 interrupt, stores each timer triggered conversion with the time it finished
  * @author Jordan Fox, Scott Beard
  * @date 12/2/2018
  */
 void ir_Handler(void)//RUN WHEN INTERRUPT IS TRIGGERED triggered in completion of ADC0SS0
 {
-    ADC0_ISC_R=ADC_ISC_IN0;// nothing will happen when interrupt method is triggered
-    return;
-    //initiate SS0 conversion
-    ADC0_PSSI_R=ADC_PSSI_SS0;
-    //wait for ADC conversion to be complete
-    while((ADC0_RIS_R & ADC_RIS_INR0) == 0){
-    //wait
-    }
+    volatile ir_sample_t *sample = &ir_samples[ir_count & (IR_BUFFER_SIZE - 1)];
     //clear interrupt
     ADC0_ISC_R=ADC_ISC_IN0;//RESET INTERRUPT SO IT CAN BE RUN AGAIN
+    sample->value = ADC0_SSFIFO0_R & 0x0FFF;
+    sample->time = timer_now();
+    ir_count++;
 }
 
 
 /**
- * This function configures the processor to use the ADC
+ * This function configures the processor to use the ADC and starts sampling every millisecond
  * @author Jordan Fox, Scott Beard
  * @date 12/2/2018
  */
@@ -68,8 +77,8 @@ void ir_init()
     //ADC STUFF
     //disable SS0 sample sequencer to configure it
     ADC0_ACTSS_R &= ~ADC_ACTSS_ASEN0;
-    //initialize the ADC trigger source as processor (default)
-    ADC0_EMUX_R = ADC_EMUX_EM0_PROCESSOR;
+    //trigger SS0 from timer 2A
+    ADC0_EMUX_R = (ADC0_EMUX_R & ~ADC_EMUX_EM0_M) | ADC_EMUX_EM0_TIMER;
     //set 1st sample to use the AIN10 ADC pin
     ADC0_SSMUX0_R |= 0x000A;
     //enable raw interrupt status & establish 1 sample per sequence
@@ -79,19 +88,112 @@ void ir_init()
     //re-enable ADC0 SS0
     ADC0_ACTSS_R |= ADC_ACTSS_ASEN0;
 
-    /*
     //INTERRUPT STUFF
     //clear interrupt flags
-    ADC0_ISC_R |= ADC_ISC_IN0;
+    ADC0_ISC_R = ADC_ISC_IN0;
     //enable ADC0SS0 interrupt
     ADC0_IM_R |= ADC_IM_MASK0;
-    //enable interrupt for IRQ 14 set bit 14 for ADC0 sequence 1
+    //enable interrupt for IRQ 14 ADC0 sequence 0, set bit 14
     NVIC_EN0_R |= 0x00004000;
     //tell cpu to use ISR handler for ADC0SS0
     IntRegister(INT_ADC0SS0, ir_Handler);
     //enable global interrupts
     IntMasterEnable();
-    */
+
+    //TIMER STUFF
+    //enable timer 2, it only triggers the ADC so it has no interrupt of its own
+    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R2;
+    while(!(SYSCTL_PRTIMER_R & SYSCTL_PRTIMER_R2));
+    TIMER2_CTL_R &= ~TIMER_CTL_TAEN;
+    TIMER2_CFG_R = TIMER_CFG_32_BIT_TIMER;
+    TIMER2_TAMR_R = TIMER_TAMR_TAMR_PERIOD;//periodic, count down
+    ir_setRate(IR_SAMPLE_PERIOD);
+}
+/**
+ * Set the time between timer triggered samples, starts sampling if it was stopped
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ * @param period time between samples in us
+ */
+void ir_setRate(uint32_t period)
+{
+    TIMER2_CTL_R &= ~TIMER_CTL_TAEN;
+    TIMER2_TAILR_R = period*16 - 1;//16 MHz clock
+    TIMER2_CTL_R |= TIMER_CTL_TAOTE | TIMER_CTL_TAEN;//timeout triggers the ADC
+    ir_sampling = 1;
+}
+/**
+ * Stop timer triggered sampling, the buffer keeps the samples already taken
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ */
+void ir_stop()
+{
+    TIMER2_CTL_R &= ~(TIMER_CTL_TAOTE | TIMER_CTL_TAEN);
+    ir_sampling = 0;
+}
+/**
+ * Most recent sample
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ * @return approximated voltage output from ir sensor, 0 if nothing has been sampled yet
+ */
+short ir_latest()
+{
+    uint32_t count = ir_count;
+    if(count == 0)
+        return 0;
+    return ir_samples[(count - 1) & (IR_BUFFER_SIZE - 1)].value;
+}
+/**
+ * Time the most recent sample was taken, compare with timer_now to ignore stale samples
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ * @return timer_now time of the latest sample in us
+ */
+uint32_t ir_latestTime()
+{
+    uint32_t count = ir_count;
+    if(count == 0)
+        return 0;
+    return ir_samples[(count - 1) & (IR_BUFFER_SIZE - 1)].time;
+}
+/**
+ * Average of the most recent samples
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ * @param window number of samples to average, at most IR_BUFFER_SIZE - 1
+ * @return approximated voltage output from ir sensor, 0 if nothing has been sampled yet
+ */
+short ir_average(int window)
+{
+    uint32_t count = ir_count;
+    int sum = 0, i;
+    if(window > IR_BUFFER_SIZE - 1)
+        window = IR_BUFFER_SIZE - 1;//leave a slot for the ISR to write while we read
+    if(window > (int)count)
+        window = count;
+    if(window <= 0)
+        return 0;
+    for(i = 1; i <= window; i++)
+        sum += ir_samples[(count - i) & (IR_BUFFER_SIZE - 1)].value;
+    return sum/window;
+}
+/**
+ * Count the buffered samples taken after a given time, lets callers wait for samples that follow a servo move
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ * @param time timer_now time to count from
+ * @return number of samples newer than time, at most 31
+ */
+int ir_samplesSince(uint32_t time)
+{
+    uint32_t count = ir_count;
+    int n = 0;
+    while(n < IR_BUFFER_SIZE - 1 && n < (int)count
+            && (int32_t)(ir_samples[(count - 1 - n) & (IR_BUFFER_SIZE - 1)].time - time) > 0)
+        n++;
+    return n;
 }
 /*
 //initiate SS1 conversion
@@ -104,25 +206,20 @@ while((ADC0_RIS_R & ADC_RIS_INR1) == 0){
 int value = ADC0_SSFIFO1_R;
 */
 /**
- * This function activates ADC conversion
+ * This function activates ADC conversion, or returns the latest sample while timer triggered sampling is running
  * @author Jordan Fox, Scott Beard
  * @date 12/2/2018
  * @return approximated voltage output from ir sensor
  */
 short ir_pulse(){
-    //disable ADC0SS0 sample sequencer to configure it
-    ADC0_ACTSS_R &= ~ADC_ACTSS_ASEN0;
-    //set 1st sample to use the channel ADC pin
-    ADC0_SSMUX0_R |= 0x000A;
-    //re-enable ADC0 SS0
-    ADC0_ACTSS_R |= ADC_ACTSS_ASEN0;
+    uint32_t count = ir_count;
+    if(ir_sampling)
+        return ir_latest();//the timer owns SS0, a fresh sample is at most one period old
     //initiate SS0 conversion
     ADC0_PSSI_R=ADC_PSSI_SS0;
-    //wait for ADC conversion to be complete
-    while((ADC0_RIS_R & ADC_RIS_INR0) == 0){}
-    //clear interrupt
-    ADC0_ISC_R=ADC_ISC_IN0;
-    return ADC0_SSFIFO0_R & 0x0FFF; //return value between 0 and 4096
+    //wait for ir_Handler to store the result
+    while(ir_count == count){}
+    return ir_latest(); //return value between 0 and 4096
 }
 
 /**
@@ -132,9 +229,24 @@ short ir_pulse(){
  * @return distance in cm
  */
 int ir_read(){
+    short raw = ir_pulse();
+    if(raw == 0)
+        return ir_cali;//nothing sampled yet, report out of range rather than divide by zero
+    return ir_cali/raw;
+}
 
-
-    return CALI/ir_pulse();
+/**
+ * Distance from the average of the most recent samples
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ * @param window number of samples to average
+ * @return distance in cm
+ */
+int ir_readAverage(int window){
+    short raw = ir_average(window);
+    if(raw == 0)
+        return ir_cali;
+    return ir_cali/raw;
 }
 
 /**
@@ -143,13 +255,13 @@ int ir_read(){
  * @date 12/2/2018
  * @return calculated variable CALI used in distance calculation
  */
-double ir_calibrate()
+float ir_calibrate()
 {
     ir_init();
     lcd_init();
 
     //assume lcd is initialzied
-    double scans[10];
+    float scans[10];
     int dist = 1;
     int mnum = 0;
     int sum;
@@ -176,21 +288,21 @@ double ir_calibrate()
             timer_waitMillis(100);
             mnum++;
         }
-        scans[dist-1] = sum/16.0;//average samples
+        scans[dist-1] = sum/16.0f;//average samples
         dist++;
     }
     //calculate P
     //P value is calculated such that P/x = distance where x is the 12 bit value from the ADC register
-    double r1 = 10000;//best and second best r values
-    double r2 = 100000;//not actually r more like a sum of percent error
+    float r1 = 10000;//best and second best r values
+    float r2 = 100000;//not actually r more like a sum of percent error
     int inc = 1000;
-    double p1 = 1;//best and second best p values
-    double p2 = 50000;
-    double test;//test P
-    double high;
-    double low;//range of test values
-    double rval;//percent error
-    double tval;//value to be compared to scans array
+    float p1 = 1;//best and second best p values
+    float p2 = 50000;
+    float test;//test P
+    float high;
+    float low;//range of test values
+    float rval;//percent error
+    float tval;//value to be compared to scans array
     while(inc >= 1)
     {
         if(p1 > p2)//set low as lower of p1 and p2
@@ -273,7 +385,7 @@ void ir_test()
             num++;
         }*/
         value = ir_pulse();//average
-        dist = CALI/value;//calculate distance with P value aka CALI
+        dist = ir_cali/value;//calculate distance with P value aka CALI
         lcd_printf("val: %hu\ndist: %d",value,dist);//print value from adc read as well as calculated distance
         timer_waitMillis(1000);//wait 1 second and repeat */
     }
@@ -293,7 +405,7 @@ void ir_cal_putty(){
     servo_init();
     servo_setAngle(90);
     char s[50];
-    double scans[10];
+    float scans[10];
     int dist = 1;
     int mnum = 0;
     int sum;
@@ -322,7 +434,7 @@ void ir_cal_putty(){
             timer_waitMillis(100);
             mnum++;
         }
-        scans[dist-1] = sum/16.0;//average samples
+        scans[dist-1] = sum/16.0f;//average samples
         sprintf(s,"%d\t%lf\n\r",(dist*10),scans[dist-1]);
         uart_sendStr(s);
         dist++;
@@ -349,19 +461,19 @@ void ir_cal_ping(){
     int measured[200];
     int actual[200];
      int x = 0;
-    double lowError = 1000000.0;
+    float lowError = 1000000.0f;
     int bestCal = 0;
-    double error = 0.0;
-    double testError;
-    double cal = 1;
+    float error = 0.0f;
+    float testError;
+    float cal = 1;
     int low;
     int high;
     int q3;//mid high = (high+q2)/2
     int q2;//mid aka (high+low)/2
     int q1;//mid low = (q2+low)/2
-    double eq3;//error at c=(high+mid)/2
-    double eq2;//error at c=mid
-    double eq1;//error at c=(mid+low)/2
+    float eq3;//error at c=(high+mid)/2
+    float eq2;//error at c=mid
+    float eq1;//error at c=(mid+low)/2
     timer_waitMillis(5000);
     servo_setAngle(90);
     timer_waitMillis(500);
@@ -385,9 +497,9 @@ void ir_cal_ping(){
         q1 = (q2+low)/2;
         lcd_printf("%d\n%d\n%d",high,q2,low);
         //test q1
-        cal = q1*1.0;
+        cal = q1*1.0f;
         x = 0;
-        error = 0.0;
+        error = 0.0f;
         while(x < num){
             testError = ((cal/measured[x])-actual[x])/actual[x];//sum of percent error
             if(testError > 0)
@@ -399,9 +511,9 @@ void ir_cal_ping(){
         eq1 = error;
 
         //test q2
-        cal = q2*1.0;
+        cal = q2*1.0f;
         x = 0;
-        error = 0.0;
+        error = 0.0f;
         while(x < num){
             testError = ((cal/measured[x])-actual[x])/actual[x];//sum of percent error
             if(testError > 0)
@@ -413,9 +525,9 @@ void ir_cal_ping(){
         eq2 = error;
 
         //test q3
-        cal = q3*1.0;
+        cal = q3*1.0f;
         x = 0;
-        error = 0.0;
+        error = 0.0f;
         while(x < num){
             testError = ((cal/measured[x])-actual[x])/actual[x];//sum of percent error
             if(testError > 0)
@@ -11,14 +11,61 @@
 #include "tm4c123gh6pm.h"
 #include "lcd.h"
 #include "timer.h"
+#include <stdint.h>
+
+extern int ir_cali; //distance in cm is ir_cali/raw reading, per cybot
+
 /**
- * This function configures the processor to use the ADC
+ * This function configures the processor to use the ADC and starts sampling every millisecond
  * @author Jordan Fox, Scott Beard
  * @date 12/2/2018
  */
 void ir_init();
 /**
- * This function activates ADC conversion
+ * Set the time between timer triggered samples, starts sampling if it was stopped
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ * @param period time between samples in us
+ */
+void ir_setRate(uint32_t period);
+/**
+ * Stop timer triggered sampling, the buffer keeps the samples already taken
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ */
+void ir_stop();
+/**
+ * Most recent sample
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ * @return approximated voltage output from ir sensor, 0 if nothing has been sampled yet
+ */
+short ir_latest();
+/**
+ * Time the most recent sample was taken, compare with timer_now to ignore stale samples
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ * @return timer_now time of the latest sample in us
+ */
+uint32_t ir_latestTime();
+/**
+ * Average of the most recent samples
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ * @param window number of samples to average, at most 31
+ * @return approximated voltage output from ir sensor, 0 if nothing has been sampled yet
+ */
+short ir_average(int window);
+/**
+ * Count the buffered samples taken after a given time, lets callers wait for samples that follow a servo move
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ * @param time timer_now time to count from
+ * @return number of samples newer than time, at most 31
+ */
+int ir_samplesSince(uint32_t time);
+/**
+ * This function activates ADC conversion, or returns the latest sample while timer triggered sampling is running
  * @author Jordan Fox, Scott Beard
  * @date 12/2/2018
  * @return approximated voltage output from ir sensor
@@ -31,13 +78,21 @@ short ir_pulse();
  * @return distance in cm
  */
 int ir_read();
+/**
+ * Distance from the average of the most recent samples
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ * @param window number of samples to average
+ * @return distance in cm
+ */
+int ir_readAverage(int window);
 /**
  * This function automates calibration process for a using a novel cybot
  * @author Jordan Fox, Scott Beard
  * @date 12/2/2018
  * @return calculated variable CALI used in distance calculation
  */
-double ir_calibrate();
+float ir_calibrate();
 /**
  * This function demonstrates ir measurement and can be used to observe accuracy
  * @author Jordan Fox, Scott Beard
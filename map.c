@@ -0,0 +1,127 @@
+/**
+ * @file map.c
+ * @brief map updates built on the occupancy grid
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+#include "map.h"
+#include "store.h"
+#include "stdlib.h"
+
+/**
+ * Walk the grid cells on the line from a sensor to where its reading ended with Bresenham's algorithm,
+ * every cell before the end is a miss and the end cell is a hit or miss, cells off the world are skipped
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x0 sensor cell column
+ * @param y0 sensor cell row
+ * @param x1 end cell column
+ * @param y1 end cell row
+ * @param sensor OCC_IR, OCC_PING or OCC_BUMP
+ * @param hit 1 if the reading hit something in the end cell, 0 if it ran out of range there
+ * @return number of cells updated
+ */
+int map_castRay(int x0, int y0, int x1, int y1, int sensor, int hit){
+    int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy, e2, n = 1;
+    while(x0 != x1 || y0 != y1){
+        occ_miss(x0, y0, sensor);
+        n++;
+        e2 = 2*err;
+        if(e2 >= dy){//step in x
+            err += dy;
+            x0 += sx;
+        }
+        if(e2 <= dx){//step in y
+            err += dx;
+            y0 += sy;
+        }
+    }
+    if(hit)
+        occ_hit(x1, y1, sensor);
+    else
+        occ_miss(x1, y1, sensor);
+    return n;
+}
+/**
+ * Encode the cells of a tile as runs
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param t tile
+ * @param put 1 to add the runs to the record being stored, 0 to only count them
+ * @return number of runs
+ */
+int map_tileRuns(const grid_tile_t *t, int put){
+    int i = 0, run, runs = 0;
+    uint8_t v, b;
+    while(i < GRID_TILE*GRID_TILE){
+        v = (t->cells[i >> GRID_TILE_SHIFT][(i & GRID_TILE_MASK) >> 1] >> ((i & 1) << 2)) & 0xF;
+        run = 1;
+        while(run < 16 && i + run < GRID_TILE*GRID_TILE
+                && ((t->cells[(i + run) >> GRID_TILE_SHIFT][((i + run) & GRID_TILE_MASK) >> 1] >> (((i + run) & 1) << 2)) & 0xF) == v)
+            run++;
+        if(put){
+            b = (v << 4) | (run - 1);
+            store_put(&b, 1);
+        }
+        runs++;
+        i += run;
+    }
+    return runs;
+}
+/**
+ * Checkpoint the map to the STORE_MAP region, tiles with objects or hazards go first and tiles that don't fit are left out
+ * Each tile is its coordinates then runs of cells in row order, a run is a byte of cell value << 4 | length - 1
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return tiles saved, -1 if the checkpoint could not be written
+ */
+int map_save(void){
+    int pass, n, saved = 0;
+    const grid_tile_t *t;
+    store_begin(STORE_MAP);
+    for(pass = 0; pass < 2; pass++){//obstacles are what matter for driving, free space can be scanned again
+        for(n = 0; n < GRID_TILES; n++){
+            t = &grid_tiles[n];
+            if(!t->used || (pass == 0) != (t->keep != 0))
+                continue;
+            if(2 + map_tileRuns(t, 0) > store_room())
+                continue;//a smaller tile might still fit
+            store_put(&t->tx, 1);
+            store_put(&t->ty, 1);
+            map_tileRuns(t, 1);
+            saved++;
+        }
+    }
+    return store_end() ? saved : -1;
+}
+/**
+ * Replace the map with the last checkpoint, log-odds restart at the threshold of each cell so new readings can still change it
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return tiles restored, -1 if there is no checkpoint
+ */
+int map_load(void){
+    int left = store_open(STORE_MAP), tiles = 0, i, x, y;
+    uint8_t tx, ty, b, v;
+    grid_tile_t *t;
+    if(left < 0)
+        return -1;
+    grid_clear();
+    while(store_get(&tx, 1) && store_get(&ty, 1)){
+        tiles++;
+        for(i = 0; i < GRID_TILE*GRID_TILE && store_get(&b, 1); ){
+            v = b >> 4;
+            for(b = (b & 0xF) + 1; b > 0 && i < GRID_TILE*GRID_TILE; b--, i++){
+                x = (tx << GRID_TILE_SHIFT) + (i & GRID_TILE_MASK);
+                y = (ty << GRID_TILE_SHIFT) + (i >> GRID_TILE_SHIFT);
+                grid_set(x, y, v);
+                t = grid_tile(x, y, 0);
+                if(t)
+                    t->occ[y & GRID_TILE_MASK][x & GRID_TILE_MASK] = v == GRID_OBJECT ? OCC_OCCUPIED : v == GRID_FREE ? OCC_FREE : 0;
+            }
+        }
+    }
+    return tiles;
+}
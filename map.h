@@ -0,0 +1,43 @@
+/**
+ * @file map.h
+ * @brief map updates built on the occupancy grid
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+
+#ifndef MAP_H_
+#define MAP_H_
+
+#include "occupancy.h"
+
+/**
+ * Walk the grid cells on the line from a sensor to where its reading ended with Bresenham's algorithm,
+ * every cell before the end is a miss and the end cell is a hit or miss, cells off the world are skipped
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x0 sensor cell column
+ * @param y0 sensor cell row
+ * @param x1 end cell column
+ * @param y1 end cell row
+ * @param sensor OCC_IR, OCC_PING or OCC_BUMP
+ * @param hit 1 if the reading hit something in the end cell, 0 if it ran out of range there
+ * @return number of cells updated
+ */
+int map_castRay(int x0, int y0, int x1, int y1, int sensor, int hit);
+/**
+ * Checkpoint the map to the STORE_MAP region, tiles with objects or hazards go first and tiles that don't fit are left out
+ * Each tile is its coordinates then runs of cells in row order, a run is a byte of cell value << 4 | length - 1
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return tiles saved, -1 if the checkpoint could not be written
+ */
+int map_save(void);
+/**
+ * Replace the map with the last checkpoint, log-odds restart at the threshold of each cell so new readings can still change it
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return tiles restored, -1 if there is no checkpoint
+ */
+int map_load(void);
+
+#endif /* MAP_H_ */
@@ -7,6 +7,7 @@
 #ifndef OBJECT_DECTECT_H_
 #define OBJECT_DETECT_H_
 
+#include "sweep.h"
 
 /**
  * Main function from lab 9 used to detect object and send information over uart
@@ -15,11 +16,12 @@
  */
 void object_detect();
 /**
- * This function is used by the cybot in the main project code to more scan the nearby environment over a 180 degree angle
+ * Find objects in a finished sweep, ir finds the edges and ping the distance
  * @author Jordan Fox, Scott Beard,  Daksh Goel, James Volpe
  * @date 12/2/2018
- * @param obj integer array of size 64 to be passed by reference and filled with information regarding detected objects
+ * @param rec scan record from sweep_start
+ * @param obj integer array of size 64 filled with up to 16 objects, for object n detect is at index 4*n, angle1 at 4*n+1, angle2 at 4*n+2, radius at 4*n+3
  */
-void scan180(int obj[64]);
+void scan_objects(const sweep_t *rec, int obj[64]);
 
 #endif /* MOVEMENT_H_ */
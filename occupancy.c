@@ -0,0 +1,82 @@
+/**
+ * @file occupancy.c
+ * @brief log-odds occupancy layer under the grid, repeated sensor readings build confidence instead of overwriting cells
+ * the log-odds live in the grid tiles so they only take memory where the cybot has looked, grid_clear resets them
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+#include "occupancy.h"
+
+//ir has a narrow beam so its hits are trusted more than ping, whose echo could come from anywhere in a wide cone
+const occ_sensor_t occ_sensors[OCC_SENSORS] = {
+    {10, -8}, //OCC_IR, one miss clears a cell but a hit needs a second reading from ir or ping to show
+    {6, -2},  //OCC_PING
+    {OCC_MAX, 0}, //OCC_BUMP, contact is certain
+};
+
+/**
+ * Threshold a log-odds value into a grid cell value
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param v log-odds value
+ * @return GRID_OBJECT, GRID_FREE or GRID_UNEXPLORED
+ */
+uint8_t occ_threshold(int v){
+    if(v >= OCC_OCCUPIED)
+        return GRID_OBJECT;
+    if(v <= OCC_FREE)
+        return GRID_FREE;
+    return GRID_UNEXPLORED;
+}
+/**
+ * Add to a cell with saturation and refresh its grid view, hazard cells keep their marking
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x cell column
+ * @param y cell row
+ * @param delta log-odds change
+ */
+void occ_add(int x, int y, int delta){
+    int v;
+    uint8_t cell;
+    int8_t *occ;
+    grid_tile_t *t;
+    if(!delta)
+        return;
+    t = grid_tile(x, y, 1);
+    if(!t)
+        return;//off the world or no tile to spare
+    occ = &t->occ[y & GRID_TILE_MASK][x & GRID_TILE_MASK];
+    v = *occ + delta;
+    if(v > OCC_MAX)
+        v = OCC_MAX;
+    if(v < OCC_MIN)
+        v = OCC_MIN;
+    *occ = v;
+
+    cell = grid_get(x, y);
+    if(cell == GRID_UNEXPLORED || cell == GRID_FREE || cell == GRID_OBJECT)
+        grid_set(x, y, occ_threshold(v));
+}
+/**
+ * A sensor reading ended in this cell, ignored if off the world
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x cell column
+ * @param y cell row
+ * @param sensor OCC_IR, OCC_PING or OCC_BUMP
+ */
+void occ_hit(int x, int y, int sensor){
+    occ_add(x, y, occ_sensors[sensor].hit);
+}
+/**
+ * A sensor reading passed through this cell, ignored if off the world
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x cell column
+ * @param y cell row
+ * @param sensor OCC_IR, OCC_PING or OCC_BUMP
+ */
+void occ_miss(int x, int y, int sensor){
+    occ_add(x, y, occ_sensors[sensor].miss);
+}
@@ -0,0 +1,61 @@
+/**
+ * @file occupancy.h
+ * @brief log-odds occupancy layer under the grid, repeated sensor readings build confidence instead of overwriting cells
+ * the log-odds live in the grid tiles so they only take memory where the cybot has looked, grid_clear resets them
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+
+#ifndef OCCUPANCY_H_
+#define OCCUPANCY_H_
+
+#include <stdint.h>
+#include "grid.h"
+
+#define OCC_MAX 64 //saturation, bounds how many readings it takes to change a confident cell
+#define OCC_MIN -64
+#define OCC_OCCUPIED 16 //at or above renders as an object
+#define OCC_FREE -8 //at or below renders as free, between the two stays unexplored
+
+//sensors, index into occ_sensors
+#define OCC_IR 0
+#define OCC_PING 1
+#define OCC_BUMP 2
+#define OCC_SENSORS 3
+
+/// log-odds change for one reading, in units of about 0.05 nats
+typedef struct {
+    int8_t hit;  //added to the cell a reading ends in
+    int8_t miss; //added to each cell a reading passes through, negative
+} occ_sensor_t;
+
+extern const occ_sensor_t occ_sensors[OCC_SENSORS];
+
+/**
+ * A sensor reading ended in this cell, ignored if off the world
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x cell column
+ * @param y cell row
+ * @param sensor OCC_IR, OCC_PING or OCC_BUMP
+ */
+void occ_hit(int x, int y, int sensor);
+/**
+ * A sensor reading passed through this cell, ignored if off the world
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x cell column
+ * @param y cell row
+ * @param sensor OCC_IR, OCC_PING or OCC_BUMP
+ */
+void occ_miss(int x, int y, int sensor);
+/**
+ * Threshold a log-odds value into a grid cell value
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param v log-odds value
+ * @return GRID_OBJECT, GRID_FREE or GRID_UNEXPLORED
+ */
+uint8_t occ_threshold(int v);
+
+#endif /* OCCUPANCY_H_ */
@@ -0,0 +1,100 @@
+/**
+ * @file odometry.c
+ * @brief differential drive odometry from the wheel encoder counts, integrated every sensor frame
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+#include "odometry.h"
+#include "fixmath.h"
+
+odo_pose_t odo_pose;
+float odo_step = 0;
+float odo_stepTurn = 0;
+float odo_moved = 0;
+float odo_turned = 0;
+uint16_t odo_left, odo_right; //counts at the last frame
+uint32_t odo_frames = 0;
+int odo_started = 0; //0 until the first frame gives the counts to start from
+
+/**
+ * Place the cybot, the encoder counts carry on from where they are
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x cell column
+ * @param y cell row
+ * @param heading ccw from +x in degrees
+ */
+void odo_set(float x, float y, float heading){
+    odo_pose.x = x;
+    odo_pose.y = y;
+    odo_pose.heading = heading;
+}
+/**
+ * Move a pose by a drive and turn, the position moves along the heading halfway through the turn, which is exact for
+ * the arc of a constant speed frame to second order
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param pose pose to move
+ * @param d mm driven, negative backwards
+ * @param turned degrees turned ccw
+ */
+void odo_move(odo_pose_t *pose, float d, float turned){
+    float mid = pose->heading + turned/2;
+    pose->x += d*fix_cos(FIX_DEG(mid))/(FIX_ONE*100.0f);//mm to dm
+    pose->y += d*fix_sin(FIX_DEG(mid))/(FIX_ONE*100.0f);
+    pose->heading += turned;
+    if(pose->heading >= 360)
+        pose->heading -= 360;
+    if(pose->heading < 0)
+        pose->heading += 360;
+}
+/**
+ * Integrate the wheel movement since the last call, call only when new sensor frames arrived
+ * The counts are 16 bit and wrap, the difference as an int16_t is right as long as a wheel turns less than 32767 counts
+ * (about 14 m) between frames
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param left left encoder count
+ * @param right right encoder count
+ * @param frames sensor frames since the last call, odo_frames advances by this
+ */
+void odo_update(uint16_t left, uint16_t right, int frames){
+    float dl, dr, d, turned;
+    if(!odo_started){
+        odo_left = left;
+        odo_right = right;
+        odo_started = 1;
+        return;
+    }
+    dl = (int16_t)(left - odo_left)*ODO_MM_PER_COUNT;
+    dr = (int16_t)(right - odo_right)*ODO_MM_PER_COUNT;
+    odo_left = left;
+    odo_right = right;
+    odo_frames += frames;
+
+    d = (dl + dr)/2;
+    turned = (dr - dl)/ODO_WHEEL_BASE*(180/3.14159265f);
+    odo_move(&odo_pose, d, turned);
+    odo_step = d;
+    odo_stepTurn = turned;
+    odo_moved += d;
+    odo_turned += turned;
+}
+/**
+ * Copy the current pose, it only changes in odo_update so a copy taken between frames is consistent
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param pose filled with the pose
+ */
+void odo_get(odo_pose_t *pose){
+    *pose = odo_pose;
+}
+/**
+ * Zero odo_moved and odo_turned
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void odo_clearMotion(void){
+    odo_moved = 0;
+    odo_turned = 0;
+}
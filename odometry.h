@@ -0,0 +1,73 @@
+/**
+ * @file odometry.h
+ * @brief differential drive odometry from the wheel encoder counts, integrated every sensor frame
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+
+#ifndef ODOMETRY_H_
+#define ODOMETRY_H_
+
+#include <stdint.h>
+
+#define ODO_COUNTS_PER_REV 508.8f //encoder counts per wheel turn, from the open interface spec
+#define ODO_WHEEL_DIAMETER 72.0f //mm
+#define ODO_MM_PER_COUNT (ODO_WHEEL_DIAMETER*3.14159265f/ODO_COUNTS_PER_REV)
+#define ODO_WHEEL_BASE 235.0f //mm between the wheels, the old 178.5 with turns scaled by 1.3 came out about the same
+
+/// Pose in map units
+typedef struct {
+    float x, y;    //cell coordinates, dm
+    float heading; //ccw from +x in degrees, 0 to 360
+} odo_pose_t;
+
+extern uint16_t odo_left, odo_right; //encoder counts at the last frame
+extern uint32_t odo_frames; //sensor frames the counts above cover, advanced only by odo_update
+extern float odo_step; //mm driven in the last odo_update
+extern float odo_stepTurn; //degrees turned ccw in the last odo_update
+extern float odo_moved; //mm driven along the path since odo_clearMotion, negative backwards
+extern float odo_turned; //degrees turned ccw since odo_clearMotion
+
+/**
+ * Place the cybot, the encoder counts carry on from where they are
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x cell column
+ * @param y cell row
+ * @param heading ccw from +x in degrees
+ */
+void odo_set(float x, float y, float heading);
+/**
+ * Move a pose by a drive and turn, the position moves along the heading halfway through the turn, which is exact for
+ * the arc of a constant speed frame to second order
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param pose pose to move
+ * @param d mm driven, negative backwards
+ * @param turned degrees turned ccw
+ */
+void odo_move(odo_pose_t *pose, float d, float turned);
+/**
+ * Integrate the wheel movement since the last call, call only when new sensor frames arrived
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param left left encoder count
+ * @param right right encoder count
+ * @param frames sensor frames since the last call, odo_frames advances by this
+ */
+void odo_update(uint16_t left, uint16_t right, int frames);
+/**
+ * Copy the current pose, it only changes in odo_update so a copy taken between frames is consistent
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param pose filled with the pose
+ */
+void odo_get(odo_pose_t *pose);
+/**
+ * Zero odo_moved and odo_turned
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void odo_clearMotion(void);
+
+#endif /* ODOMETRY_H_ */
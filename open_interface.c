@@ -14,6 +14,10 @@
  */
 
 #include "open_interface.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include "driverlib/interrupt.h"
+#include "bench.h"
 
 #define OI_OPCODE_START            128
 #define OI_OPCODE_BAUD             129
@@ -80,6 +84,156 @@
 
 #define SENSOR_PACKET_SIZE	80
 
+// Packets 7-58 make up group 100
+#define OI_FIRST_PACKET		7
+#define OI_LAST_PACKET		58
+// Longest sensor list oi_setSensorList accepts
+#define OI_MAX_PACKETS		16
+
+// How a field is stored in its packet
+#define OI_U8	0	//one byte
+#define OI_BIT	1	//one bit of a byte, stored as 0 or 1
+#define OI_U16	2	//big-endian unsigned
+#define OI_S16	3	//big-endian signed
+
+/// Where one oi_t field comes from
+typedef struct {
+	uint8_t id;		//packet id
+	uint8_t offset;	//byte offset in the packet data
+	uint8_t type;	//OI_U8, OI_BIT, OI_U16 or OI_S16
+	uint8_t bit;	//bit mask for OI_BIT
+	uint16_t dest;	//offset of the field in oi_t
+	uint16_t group;	//OI_FIELDS_ group used to skip fields nobody reads
+} oi_field_t;
+
+#define OI_FIELD(id, offset, type, bit, field, group) {id, offset, type, bit, offsetof(oi_t, field), group}
+
+// Every field the parser can fill, sorted by packet id
+const oi_field_t oi_fields[] = {
+	OI_FIELD(7, 0, OI_BIT, 0x08, wheelDropLeft, OI_FIELDS_BUMP),
+	OI_FIELD(7, 0, OI_BIT, 0x04, wheelDropRight, OI_FIELDS_BUMP),
+	OI_FIELD(7, 0, OI_BIT, 0x02, bumpLeft, OI_FIELDS_BUMP),
+	OI_FIELD(7, 0, OI_BIT, 0x01, bumpRight, OI_FIELDS_BUMP),
+	OI_FIELD(8, 0, OI_U8, 0, wallSensor, OI_FIELDS_WALL),
+	OI_FIELD(9, 0, OI_U8, 0, cliffLeft, OI_FIELDS_CLIFF),
+	OI_FIELD(10, 0, OI_U8, 0, cliffFrontLeft, OI_FIELDS_CLIFF),
+	OI_FIELD(11, 0, OI_U8, 0, cliffFrontRight, OI_FIELDS_CLIFF),
+	OI_FIELD(12, 0, OI_U8, 0, cliffRight, OI_FIELDS_CLIFF),
+	OI_FIELD(13, 0, OI_U8, 0, virtualWall, OI_FIELDS_WALL),
+	OI_FIELD(14, 0, OI_BIT, 0x10, overcurrentLeftWheel, OI_FIELDS_CURRENT),
+	OI_FIELD(14, 0, OI_BIT, 0x08, overcurrentRightWheel, OI_FIELDS_CURRENT),
+	OI_FIELD(14, 0, OI_BIT, 0x04, overcurrentMainBrush, OI_FIELDS_CURRENT),
+	OI_FIELD(14, 0, OI_BIT, 0x01, overcurrentSideBrush, OI_FIELDS_CURRENT),
+	OI_FIELD(15, 0, OI_U8, 0, dirtDetect, OI_FIELDS_MISC),
+	OI_FIELD(17, 0, OI_U8, 0, infraredCharOmni, OI_FIELDS_IR),
+	OI_FIELD(18, 0, OI_BIT, 0x80, buttonClock, OI_FIELDS_BUTTON),
+	OI_FIELD(18, 0, OI_BIT, 0x40, buttonSchedule, OI_FIELDS_BUTTON),
+	OI_FIELD(18, 0, OI_BIT, 0x20, buttonDay, OI_FIELDS_BUTTON),
+	OI_FIELD(18, 0, OI_BIT, 0x10, buttonHour, OI_FIELDS_BUTTON),
+	OI_FIELD(18, 0, OI_BIT, 0x08, buttonMinute, OI_FIELDS_BUTTON),
+	OI_FIELD(18, 0, OI_BIT, 0x04, buttonDock, OI_FIELDS_BUTTON),
+	OI_FIELD(18, 0, OI_BIT, 0x02, buttonSpot, OI_FIELDS_BUTTON),
+	OI_FIELD(18, 0, OI_BIT, 0x01, buttonClean, OI_FIELDS_BUTTON),
+	OI_FIELD(19, 0, OI_S16, 0, distance, OI_FIELDS_MOTION),
+	//20 angle is unused, it comes from the encoders
+	OI_FIELD(21, 0, OI_U8, 0, chargingState, OI_FIELDS_BATTERY),
+	OI_FIELD(22, 0, OI_U16, 0, batteryVoltage, OI_FIELDS_BATTERY),
+	OI_FIELD(23, 0, OI_S16, 0, batteryCurrent, OI_FIELDS_BATTERY),
+	OI_FIELD(24, 0, OI_U8, 0, batteryTemperature, OI_FIELDS_BATTERY),
+	OI_FIELD(25, 0, OI_U16, 0, batteryCharge, OI_FIELDS_BATTERY),
+	OI_FIELD(26, 0, OI_U16, 0, batteryCapacity, OI_FIELDS_BATTERY),
+	OI_FIELD(27, 0, OI_U16, 0, wallSignal, OI_FIELDS_WALL),
+	OI_FIELD(28, 0, OI_U16, 0, cliffLeftSignal, OI_FIELDS_CLIFF_SIGNAL),
+	OI_FIELD(29, 0, OI_U16, 0, cliffFrontLeftSignal, OI_FIELDS_CLIFF_SIGNAL),
+	OI_FIELD(30, 0, OI_U16, 0, cliffFrontRightSignal, OI_FIELDS_CLIFF_SIGNAL),
+	OI_FIELD(31, 0, OI_U16, 0, cliffRightSignal, OI_FIELDS_CLIFF_SIGNAL),
+	OI_FIELD(34, 0, OI_U8, 0, chargingSourcesAvailable, OI_FIELDS_MISC),
+	OI_FIELD(35, 0, OI_U8, 0, oiMode, OI_FIELDS_MISC),
+	OI_FIELD(36, 0, OI_U8, 0, songNumber, OI_FIELDS_SONG),
+	OI_FIELD(37, 0, OI_U8, 0, songPlaying, OI_FIELDS_SONG),
+	OI_FIELD(38, 0, OI_U8, 0, numberOfStreamPackets, OI_FIELDS_MISC),
+	OI_FIELD(39, 0, OI_S16, 0, requestedVelocity, OI_FIELDS_MOTION),
+	OI_FIELD(40, 0, OI_S16, 0, requestedRadius, OI_FIELDS_MOTION),
+	OI_FIELD(41, 0, OI_S16, 0, requestedRightVelocity, OI_FIELDS_MOTION),
+	OI_FIELD(42, 0, OI_S16, 0, requestedLeftVelocity, OI_FIELDS_MOTION),
+	OI_FIELD(43, 0, OI_U16, 0, leftEncoderCount, OI_FIELDS_MOTION),
+	OI_FIELD(44, 0, OI_U16, 0, rightEncoderCount, OI_FIELDS_MOTION),
+	OI_FIELD(45, 0, OI_BIT, 0x20, lightBumperRight, OI_FIELDS_LIGHT_BUMP),
+	OI_FIELD(45, 0, OI_BIT, 0x10, lightBumperFrontRight, OI_FIELDS_LIGHT_BUMP),
+	OI_FIELD(45, 0, OI_BIT, 0x08, lightBumperCenterRight, OI_FIELDS_LIGHT_BUMP),
+	OI_FIELD(45, 0, OI_BIT, 0x04, lightBumperCenterLeft, OI_FIELDS_LIGHT_BUMP),
+	OI_FIELD(45, 0, OI_BIT, 0x02, lightBumperFrontLeft, OI_FIELDS_LIGHT_BUMP),
+	OI_FIELD(45, 0, OI_BIT, 0x01, lightBumperLeft, OI_FIELDS_LIGHT_BUMP),
+	OI_FIELD(46, 0, OI_U16, 0, lightBumpLeftSignal, OI_FIELDS_LIGHT_BUMP),
+	OI_FIELD(47, 0, OI_U16, 0, lightBumpFrontLeftSignal, OI_FIELDS_LIGHT_BUMP),
+	OI_FIELD(48, 0, OI_U16, 0, lightBumpCenterLeftSignal, OI_FIELDS_LIGHT_BUMP),
+	OI_FIELD(49, 0, OI_U16, 0, lightBumpCenterRightSignal, OI_FIELDS_LIGHT_BUMP),
+	OI_FIELD(50, 0, OI_U16, 0, lightBumpFrontRightSignal, OI_FIELDS_LIGHT_BUMP),
+	OI_FIELD(51, 0, OI_U16, 0, lightBumpRightSignal, OI_FIELDS_LIGHT_BUMP),
+	OI_FIELD(52, 0, OI_U8, 0, infraredCharLeft, OI_FIELDS_IR),
+	OI_FIELD(53, 0, OI_U8, 0, infraredCharRight, OI_FIELDS_IR),
+	OI_FIELD(54, 0, OI_S16, 0, leftMotorCurrent, OI_FIELDS_CURRENT),
+	OI_FIELD(55, 0, OI_S16, 0, rightMotorCurrent, OI_FIELDS_CURRENT),
+	OI_FIELD(56, 0, OI_S16, 0, mainBrushMotorCurrent, OI_FIELDS_CURRENT),
+	OI_FIELD(57, 0, OI_S16, 0, sideBrushMotorCurrent, OI_FIELDS_CURRENT),
+	OI_FIELD(58, 0, OI_U8, 0, stasis, OI_FIELDS_MISC)
+};
+#define OI_NUM_FIELDS (sizeof(oi_fields) / sizeof(oi_fields[0]))
+
+// First entry in oi_fields for each packet id, and the field groups each packet holds
+uint8_t oi_firstField[OI_LAST_PACKET + 2];
+uint16_t oi_packetFields[OI_LAST_PACKET + 1];
+uint16_t oi_fieldMask = OI_FIELDS_ALL;
+
+// Data bytes in each sensor packet, indexed by packet id
+const uint8_t oi_packetSize[OI_LAST_PACKET + 1] = {
+	0, 0, 0, 0, 0, 0, 0,			//0-6 are groups
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1,	//7-16
+	1, 1, 2, 2, 1, 2, 2, 1, 2, 2,	//17-26
+	2, 2, 2, 2, 2, 1, 2, 1, 1, 1,	//27-36
+	1, 1, 2, 2, 2, 2, 2, 2, 1, 2,	//37-46
+	2, 2, 2, 2, 2, 1, 1, 2, 2, 2,	//47-56
+	2, 1							//57-58
+};
+
+// Stream frames are [19][n][packet id][data]...[checksum], all bytes sum to 0
+#define OI_STREAM_HEADER	19
+#define OI_STREAM_BODY_MAX	(SENSOR_PACKET_SIZE + 1)
+// Frames held for oi_update, the Create sends one every 15 ms
+#define OI_FRAME_QUEUE		4
+// Bytes held for oi_uartReceive while the stream is paused
+#define OI_RAW_SIZE			32
+
+// Frame parser states
+#define OI_WAIT_HEADER		0
+#define OI_WAIT_LENGTH		1
+#define OI_WAIT_BODY		2
+#define OI_WAIT_CHECKSUM	3
+
+// Complete frames published by the UART4 interrupt, only the interrupt writes oi_frameHead
+volatile uint8_t oi_frames[OI_FRAME_QUEUE][OI_STREAM_BODY_MAX];
+volatile uint8_t oi_frameLength[OI_FRAME_QUEUE];
+volatile uint8_t oi_frameHead = 0;
+volatile uint8_t oi_frameTail = 0;
+
+// Raw bytes received while not streaming, for oi_uartReceive
+volatile char oi_raw[OI_RAW_SIZE];
+volatile uint8_t oi_rawHead = 0;
+volatile uint8_t oi_rawTail = 0;
+
+volatile uint8_t oi_streaming = 0;
+// Packets streamed by oi_streamStart and read by oi_query
+uint8_t oi_sensorList[OI_MAX_PACKETS] = {OI_SENSOR_PACKET_GROUP100};
+uint8_t oi_sensorCount = 1;
+// Offset of the distance packet in the frame body, so distance is not lost when a frame is dropped
+volatile uint8_t oi_streamDistanceOffset = 0;
+volatile int32_t oi_droppedDistance = 0;
+
+volatile uint32_t oi_frameErrors = 0;
+volatile uint32_t oi_framesDropped = 0;
+// oi_framesDropped when oi_update last counted frames
+uint32_t oi_framesCounted = 0;
+
 
 /// Initialize the iRobot open interface without updating a struct
 /// internal function
@@ -104,13 +258,46 @@ void uart_sendStr(const char *theData);
 ///	internal function
 char oi_uartReceive(void);
 
+///UART4 interrupt, runs the stream frame parser
+///	internal function
+void UART4_Handler(void);
+
+///Start streaming the sensor list
+///	internal function
+void oi_streamStart(void);
+
+///Parse a stream frame body into the oi_t struct
+///	internal function
+void oi_parseFrame(oi_t* self, uint8_t body[], uint8_t length);
+
+///Pause the sensor stream
+///	internal function
+void oi_streamStop(void);
+
+///Drop any bytes waiting for oi_uartReceive
+///	internal function
+void oi_rawFlush(void);
+
 ///Parse data from iRobot into oi_t struct
 void oi_parsePacket(oi_t* self, uint8_t packet[]);
 
+///Parse a single sensor packet into oi_t struct
+void oi_parseSensor(oi_t* self, uint8_t id, uint8_t data[]);
+
+///Number of data bytes in a sensor packet
+uint8_t oi_sizeOf(uint8_t id);
+
+///Build the per packet indexes into the field table
+void oi_fieldsInit(void);
+
 ///Send large data set from array
 ///	internal function
 void oi_uartSendBuff(const uint8_t theData[], uint8_t theSize);
 
+///Load a script that drives the wheels until a wait command ends, then stops them, and start it
+///	internal function
+void oi_runScript(int16_t right_wheel, int16_t left_wheel, uint8_t wait, int16_t amount);
+
 ///Helper function to convert big-endian integer from pointer into little endian integer
 /// internal function
 int16_t oi_parseInt(uint8_t* theInt);
@@ -133,8 +320,10 @@ void oi_free(oi_t *self)
 
 void oi_init_noupdate()
 {
+	oi_fieldsInit();
 	oi_uartInit();
 	oi_uartSendChar(OI_OPCODE_START);
+	oi_streamStop(); //stream may still be running from before a reset
 
 	oi_uartSendChar(OI_OPCODE_FULL);		//Use full mode, unrestricted control
 	oi_setLeds(1,1,7,255);
@@ -156,132 +345,282 @@ void oi_init(oi_t *self)
 {
 	oi_init_noupdate();
 
-	oi_update(self);
-	oi_update(self); //Call twice to clear distance/angle
+	oi_streamStart();
+	while(oi_frameHead == oi_frameTail); //wait for the first frame
 
+	oi_update(self);
+	self->distance = 0; //clear distance/angle
+	self->angle = 0;
 }
 
 void oi_close() {
 	oi_setWheels(0, 0);
+	oi_streamStop();
 	oi_uartSendChar(OI_OPCODE_STOP);
 }
 
-///Update all sensor and store in oi_t struct
-void oi_update(oi_t *self)
+///Start streaming the sensor list, a frame arrives every 15 ms
+void oi_streamStart(void)
 {
-	uint8_t sensorBuffer[SENSOR_PACKET_SIZE];
-
-	//Query list of sensors
-	oi_uartSendChar(OI_OPCODE_SENSORS);
-	oi_uartSendChar(OI_SENSOR_PACKET_GROUP100);
-
-	// Read all the sensor data
 	uint8_t i;
-	for (i = 0; i < SENSOR_PACKET_SIZE; i++) {
-		// read each sensor byte
-		sensorBuffer[i] = oi_uartReceive();
+	uint8_t offset = 0;
+
+	//find the distance data in the frame body, which is [packet id][data] for each packet
+	oi_streamDistanceOffset = 0;
+	for (i = 0; i < oi_sensorCount; i++) {
+		if (oi_sensorList[i] == 19)
+			oi_streamDistanceOffset = offset + 1;
+		else if (oi_sensorList[i] == OI_SENSOR_PACKET_GROUP100)
+			oi_streamDistanceOffset = offset + 1 + 12; //distance is bytes 12-13 of group 100
+		offset += 1 + oi_sizeOf(oi_sensorList[i]);
 	}
+	oi_streaming = 1;
 
-	//Parse the sensor data into the struct
-	oi_parsePacket(self, sensorBuffer);
-
-	timer_waitMillis(25); // reduces USART errors that occur when continuously transmitting/receiving min wait time=15ms
+	oi_uartSendChar(OI_OPCODE_STREAM);
+	oi_uartSendChar(oi_sensorCount);
+	for (i = 0; i < oi_sensorCount; i++) {
+		oi_uartSendChar(oi_sensorList[i]);
+	}
 }
 
-void oi_parsePacket(oi_t* self, uint8_t packet[]) {
-	self->wheelDropLeft = !!(packet[0] & 0x08);
-	self->wheelDropRight = !!(packet[0] & 0x04);
-	self->bumpLeft = !!(packet[0] & 0x02);
-	self->bumpRight = packet[0] & 0x01;
+///Pause the sensor stream, received bytes go to oi_uartReceive again
+void oi_streamStop(void)
+{
+	oi_uartSendChar(OI_OPCODE_DO_STREAM);
+	oi_uartSendChar(0); //0 = pause
+	oi_streaming = 0;
+}
 
-	self->wallSensor = packet[1];
+///Drop any bytes waiting for oi_uartReceive, the tail of a frame that was in flight when the stream paused lands
+///here, so call it after the pause settles and before sending a command that replies
+void oi_rawFlush(void)
+{
+	UART4_IM_R &= ~(UART_IM_RXIM | UART_IM_RTIM); //keep the interrupt from adding to it while we reset it
+	oi_rawHead = 0;
+	oi_rawTail = 0;
+	UART4_IM_R |= UART_IM_RXIM | UART_IM_RTIM;
+}
 
-	self->cliffLeft = packet[2];
-	self->cliffFrontLeft = packet[3];
-	self->cliffFrontRight = packet[4];
-	self->cliffRight = packet[5];
+///Update all sensor and store in oi_t struct
+///Parses every frame received since the last call without waiting, distance and angle are summed over them
+///Returns the frames received, so callers can tell a period without a frame from one with several
+int oi_update(oi_t *self)
+{
+	int32_t distance;
+	int32_t angle = 0;
+	int frames;
+
+	UART4_IM_R &= ~(UART_IM_RXIM | UART_IM_RTIM); //keep the interrupt from adding to it while we take it
+	distance = oi_droppedDistance;
+	oi_droppedDistance = 0;
+	frames = oi_framesDropped - oi_framesCounted; //their distance is in oi_droppedDistance
+	oi_framesCounted = oi_framesDropped;
+	UART4_IM_R |= UART_IM_RXIM | UART_IM_RTIM;
+
+	while(oi_frameTail != oi_frameHead) {
+		self->distance = 0; //only set by frames that carry them
+		self->angle = 0;
+		oi_parseFrame(self, (uint8_t *) oi_frames[oi_frameTail], oi_frameLength[oi_frameTail]);
+		distance += self->distance;
+		angle += self->angle;
+		oi_frameTail = (oi_frameTail + 1) % OI_FRAME_QUEUE;
+		frames++;
+	}
 
-	self->virtualWall = packet[6];
+	self->distance = distance;
+	self->angle = angle;
+	return frames;
+}
 
-	self->overcurrentLeftWheel = !!(packet[7] & 0x10);
-	self->overcurrentRightWheel = !!(packet[7] & 0x08);
-	self->overcurrentMainBrush = !!(packet[7] & 0x04);
-	self->overcurrentSideBrush = packet[7] & 0x01;
+///Parse a group 100 packet, packets 7-58 back to back
+void oi_parsePacket(oi_t* self, uint8_t packet[]) {
+	uint8_t id;
 
-	self->dirtDetect = packet[8];
+	for (id = OI_FIRST_PACKET; id <= OI_LAST_PACKET; id++) {
+		if (oi_packetFields[id] & oi_fieldMask) //skip packets nobody reads
+			oi_parseSensor(self, id, packet);
+		packet += oi_packetSize[id];
+	}
+}
 
-	//Byte 9 unused
+///Parse a single sensor packet into the oi_t struct using the field table
+void oi_parseSensor(oi_t* self, uint8_t id, uint8_t data[]) {
+	const oi_field_t *field;
+	uint8_t *dest;
 
-	self->infraredCharOmni = packet[10];
+	if (id == OI_SENSOR_PACKET_GROUP100) {
+		oi_parsePacket(self, data);
+		return;
+	}
+	if (id > OI_LAST_PACKET)
+		return;
+
+	for (field = oi_fields + oi_firstField[id]; field < oi_fields + oi_firstField[id + 1]; field++) {
+		if (!(field->group & oi_fieldMask))
+			continue;
+		dest = (uint8_t *) self + field->dest;
+		switch (field->type) {
+		case OI_U8:
+			*dest = data[field->offset];
+			break;
+		case OI_BIT:
+			*dest = !!(data[field->offset] & field->bit);
+			break;
+		case OI_U16:
+			*(uint16_t *) dest = (uint16_t) oi_parseInt(data + field->offset);
+			break;
+		case OI_S16:
+			*(int16_t *) dest = oi_parseInt(data + field->offset);
+			break;
+		}
+	}
 
-	self->buttonClock = !!(packet[11] & 0x80);
-	self->buttonSchedule = !!(packet[11] & 0x40);
-	self->buttonDay = !!(packet[11] & 0x20);
-	self->buttonHour = !!(packet[11] & 0x10);
-	self->buttonMinute = !!(packet[11] & 0x08);
-	self->buttonDock = !!(packet[11] & 0x04);
-	self->buttonSpot = !!(packet[11] & 0x02);
-	self->buttonClean = packet[11] & 0x01;
+	if (id == 44 && (oi_fieldMask & OI_FIELDS_MOTION))
+		self->angle = getDegrees(self); //left count is always parsed first
+}
 
-	self->distance = oi_parseInt(packet + 12);
+///Build the per packet indexes into the field table
+///	internal function
+void oi_fieldsInit(void) {
+	uint8_t f = 0;
+	uint8_t id;
+
+	for (id = 0; id <= OI_LAST_PACKET; id++) {
+		oi_firstField[id] = f;
+		oi_packetFields[id] = 0;
+		while (f < OI_NUM_FIELDS && oi_fields[f].id == id) {
+			oi_packetFields[id] |= oi_fields[f].group;
+			f++;
+		}
+	}
+	oi_firstField[OI_LAST_PACKET + 1] = f;
+}
 
+/// \brief Choose which oi_t fields the parser fills in, fields outside the mask keep their old value
+/// \param mask OR of OI_FIELDS_ groups, OI_FIELDS_ALL by default
+void oi_setFieldMask(uint16_t mask) {
+	oi_fieldMask = mask;
+}
 
-	self->chargingState = packet[16];
-	self->batteryVoltage = oi_parseInt(packet + 17);
-	self->batteryCurrent = oi_parseInt(packet + 19);
-	self->batteryTemperature = packet[21];
-	self->batteryCharge = oi_parseInt(packet + 22);
-	self->batteryCapacity = oi_parseInt(packet + 24);
+///Parse a stream frame body, [packet id][data] repeated
+///	internal function
+void oi_parseFrame(oi_t* self, uint8_t body[], uint8_t length) {
+	uint8_t i = 0;
+	uint8_t id;
+
+	while (i < length) {
+		id = body[i++];
+		if (!oi_sizeOf(id) || i + oi_sizeOf(id) > length)
+			return; //checksum passed but the frame does not match the packet table
+		oi_parseSensor(self, id, body + i);
+		i += oi_sizeOf(id);
+	}
+}
 
-	self->wallSignal = oi_parseInt(packet + 26);
+///Number of data bytes in a sensor packet, 0 for unsupported ids
+uint8_t oi_sizeOf(uint8_t id) {
+	if (id == OI_SENSOR_PACKET_GROUP100)
+		return SENSOR_PACKET_SIZE;
+	if (id > OI_LAST_PACKET)
+		return 0;
+	return oi_packetSize[id];
+}
 
-	self->cliffLeftSignal = oi_parseInt(packet + 28);
-	self->cliffFrontLeftSignal = oi_parseInt(packet + 30);
-	self->cliffFrontRightSignal = oi_parseInt(packet + 32);
-	self->cliffRightSignal = oi_parseInt(packet + 34);
+/// \brief Choose the sensor packets read by oi_update and oi_query
+/// \param ids packet ids 7-58, or 100 for all of them
+/// \param n number of ids
+/// \return 0 on success, -1 if an id is unsupported or the packets do not fit in a stream frame
+int oi_setSensorList(const uint8_t *ids, uint8_t n) {
+	uint8_t i;
+	uint8_t length = 0;
+
+	if (n == 0 || n > OI_MAX_PACKETS)
+		return -1;
+	for (i = 0; i < n; i++) {
+		if (!oi_sizeOf(ids[i]))
+			return -1;
+		length += 1 + oi_sizeOf(ids[i]);
+	}
+	if (length > OI_STREAM_BODY_MAX)
+		return -1;
 
-	//Bytes 36-38 unused
+	for (i = 0; i < n; i++)
+		oi_sensorList[i] = ids[i];
+	oi_sensorCount = n;
 
-	self->chargingSourcesAvailable = packet[39];
-	self->oiMode = packet[40];
+	if (oi_streaming)
+		oi_streamStart(); //restart the stream with the new list
+	return 0;
+}
 
-	self->songNumber = packet[41];
-	self->songPlaying = packet[42];
+/// \brief Measure parse time of a fresh group 100 packet with all fields and with the current field mask
+/// Prints cycles per parse to the LCD
+void oi_parseBench(oi_t *self) {
+	uint8_t packet[SENSOR_PACKET_SIZE];
+	uint16_t mask = oi_fieldMask;
+	uint32_t start;
+	uint32_t all;
+	uint32_t selected;
+	uint8_t i;
+	int n;
 
-	self->numberOfStreamPackets = packet[43];
+	//take one real packet with the stream paused
+	oi_streamStop();
+	timer_waitMillis(20); //let a frame in flight finish
+	oi_rawFlush(); //its tail is in the ring now, the reply comes after it
+	oi_uartSendChar(OI_OPCODE_SENSORS);
+	oi_uartSendChar(OI_SENSOR_PACKET_GROUP100);
+	for (i = 0; i < SENSOR_PACKET_SIZE; i++) {
+		packet[i] = oi_uartReceive();
+	}
 
-	self->requestedVelocity = oi_parseInt(packet + 44);
-	self->requestedRadius = oi_parseInt(packet + 46);
-	self->requestedRightVelocity = oi_parseInt(packet + 48);
-	self->requestedLeftVelocity = oi_parseInt(packet + 50);
-	self->leftEncoderCount = oi_parseInt(packet + 52);
-	self->rightEncoderCount = oi_parseInt(packet + 54);
+	bench_init();
+	oi_fieldMask = OI_FIELDS_ALL;
+	start = bench_cycles();
+	for (n = 0; n < 100; n++) {
+		oi_parsePacket(self, packet);
+	}
+	all = (bench_cycles() - start) / 100;
 
-	self->lightBumperRight = !!(packet[56] & 0x20);
-	self->lightBumperFrontRight = !!(packet[56] & 0x10);
-	self->lightBumperCenterRight = !!(packet[56] & 0x08);
-	self->lightBumperCenterLeft = !!(packet[56] & 0x04);
-	self->lightBumperFrontLeft = !!(packet[56] & 0x02);
-	self->lightBumperLeft = packet[56] & 0x01;
+	oi_fieldMask = mask;
+	start = bench_cycles();
+	for (n = 0; n < 100; n++) {
+		oi_parsePacket(self, packet);
+	}
+	selected = (bench_cycles() - start) / 100;
 
-	self->lightBumpLeftSignal = oi_parseInt(packet + 57);
-	self->lightBumpFrontLeftSignal = oi_parseInt(packet + 59);
-	self->lightBumpCenterLeftSignal = oi_parseInt(packet + 61);
-	self->lightBumpCenterRightSignal = oi_parseInt(packet + 63);
-	self->lightBumpFrontRightSignal = oi_parseInt(packet + 65);
-	self->lightBumpRightSignal = oi_parseInt(packet + 67);
+	oi_streamStart();
+	lcd_printf("Parse cycles\nall: %d\nmask %04x: %d", (int) all, mask, (int) selected);
+}
 
-	self->infraredCharLeft = packet[69];
-	self->infraredCharRight = packet[70];
+///Read the sensor list once with the query list opcode, the stream is paused while it waits for the reply
+void oi_query(oi_t *self) {
+	uint8_t buffer[SENSOR_PACKET_SIZE];
+	uint8_t streaming = oi_streaming;
+	uint8_t i;
+	uint8_t j;
 
-	self->leftMotorCurrent = oi_parseInt(packet + 71);
-	self->rightMotorCurrent = oi_parseInt(packet + 73);
-	self->mainBrushMotorCurrent = oi_parseInt(packet + 75);
-	self->sideBrushMotorCurrent = oi_parseInt(packet + 77);
+	if (streaming) {
+		oi_streamStop();
+		timer_waitMillis(20); //let a frame in flight finish
+	}
+	oi_rawFlush(); //so the reply isn't read behind stale stream bytes
+	oi_uartSendChar(OI_OPCODE_QUERY_LIST);
+	oi_uartSendChar(oi_sensorCount);
+	for (i = 0; i < oi_sensorCount; i++) {
+		oi_uartSendChar(oi_sensorList[i]);
+	}
 
-	self->stasis = packet[79];
+	//the reply is the data of each packet in list order, without ids
+	for (i = 0; i < oi_sensorCount; i++) {
+		for (j = 0; j < oi_sizeOf(oi_sensorList[i]); j++) {
+			buffer[j] = oi_uartReceive();
+		}
+		oi_parseSensor(self, oi_sensorList[i], buffer);
+	}
 
-	self->angle = getDegrees(self);
+	if (streaming)
+		oi_streamStart();
 }
 
 inline int16_t oi_parseInt(uint8_t* theInt) {
@@ -320,6 +659,43 @@ void oi_setWheels(int16_t right_wheel, int16_t left_wheel)
 	oi_uartSendChar(left_wheel& 0xff);
 }
 
+/// Load a script that drives the wheels until a wait command ends, then stops them, and start it
+///	internal function
+void oi_runScript(int16_t right_wheel, int16_t left_wheel, uint8_t wait, int16_t amount)
+{
+	const uint8_t script[] = {
+		OI_OPCODE_SCRIPT, 13,
+		OI_OPCODE_DRIVE_WHEELS, right_wheel >> 8, right_wheel & 0xff, left_wheel >> 8, left_wheel & 0xff,
+		wait, amount >> 8, amount & 0xff,
+		OI_OPCODE_DRIVE_WHEELS, 0, 0, 0, 0
+	};
+	oi_uartSendBuff(script, sizeof(script));
+	oi_uartSendChar(OI_OPCODE_PLAY_SCRIPT);
+}
+
+/// \brief Drive straight until the Create has measured a distance on its own encoders, then stop
+/// The Create ends the motion itself with its script engine, but ignores every command, stop included, until it does.
+/// Only the original Create runs scripts, the Create 2 OI has no opcodes 152-158
+/// \param speed mm/s 0 -> 500
+/// \param distance mm, negative backwards
+void oi_driveDistance(int16_t speed, int16_t distance)
+{
+	if (distance < 0)
+		speed = -speed;
+	oi_runScript(speed, speed, OI_OPCODE_WAIT_DISTANCE, distance);
+}
+
+/// \brief Turn in place until the Create has measured an angle on its own encoders, then stop
+/// Same script engine limits as oi_driveDistance
+/// \param speed mm/s of each wheel 0 -> 500
+/// \param angle degrees, positive counterclockwise
+void oi_turnAngle(int16_t speed, int16_t angle)
+{
+	if (angle < 0)
+		speed = -speed;
+	oi_runScript(speed, -speed, OI_OPCODE_WAIT_ANGLE, angle);
+}
+
 
 /// \brief Load song sequence
 /// \param An integer value from 0 - 15 that acts as a label for note sequence
@@ -389,11 +765,93 @@ void oi_uartInit(void)
 	UART4_IBRD_R = iBRD;
 	UART4_FBRD_R = fBRD;
 
-	UART4_LCRH_R = UART_LCRH_WLEN_8; //8 bit, 1 stop, no parity, no FIFO
+	UART4_LCRH_R = UART_LCRH_WLEN_8 | UART_LCRH_FEN; //8 bit, 1 stop, no parity, FIFO
 	UART4_CC_R = UART_CC_CS_SYSCLK; //Use System Clock
+
+	UART4_IFLS_R = UART_IFLS_RX4_8; //Interrupt at half full, receive timeout catches the end of a frame
+	UART4_ICR_R = UART_ICR_RXIC | UART_ICR_RTIC;
+	UART4_IM_R |= UART_IM_RXIM | UART_IM_RTIM;
+	NVIC_EN1_R |= 0x10000000; //enable IRQ 60, UART4
+	IntRegister(INT_UART4, UART4_Handler);
+	IntMasterEnable();
+
 	UART4_CTL_R = UART_CTL_RXE | UART_CTL_TXE | UART_CTL_UARTEN; //Enable Rx, Tx and UART module
 }
 
+///UART4 interrupt, feeds received bytes through the stream frame parser
+///Frames with a bad length or checksum are dropped and the parser waits for the next header
+void UART4_Handler(void)
+{
+	static uint8_t state = OI_WAIT_HEADER;
+	static uint8_t length;
+	static uint8_t count;
+	static uint8_t sum;
+	volatile uint8_t *frame;
+	uint8_t next;
+	uint8_t data;
+
+	UART4_ICR_R = UART_ICR_RXIC | UART_ICR_RTIC;
+
+	while(!(UART4_FR_R & UART_FR_RXFE)) {
+		data = UART4_DR_R & 0xFF;
+
+		if(!oi_streaming) {
+			next = (oi_rawHead + 1) % OI_RAW_SIZE;
+			if(next != oi_rawTail) {
+				oi_raw[oi_rawHead] = data;
+				oi_rawHead = next;
+			}
+			state = OI_WAIT_HEADER;
+			continue;
+		}
+
+		//the slot at oi_frameHead is never read by oi_update until it is published
+		frame = oi_frames[oi_frameHead];
+		switch(state) {
+		case OI_WAIT_HEADER:
+			if(data == OI_STREAM_HEADER) {
+				sum = data;
+				state = OI_WAIT_LENGTH;
+			}
+			break;
+		case OI_WAIT_LENGTH:
+			if(data == 0 || data > OI_STREAM_BODY_MAX) {
+				oi_frameErrors++;
+				state = OI_WAIT_HEADER;
+				break;
+			}
+			length = data;
+			count = 0;
+			sum += data;
+			state = OI_WAIT_BODY;
+			break;
+		case OI_WAIT_BODY:
+			frame[count++] = data;
+			sum += data;
+			if(count == length)
+				state = OI_WAIT_CHECKSUM;
+			break;
+		case OI_WAIT_CHECKSUM:
+			state = OI_WAIT_HEADER;
+			if((uint8_t)(sum + data) != 0) {
+				oi_frameErrors++;
+				break;
+			}
+			next = (oi_frameHead + 1) % OI_FRAME_QUEUE;
+			if(next == oi_frameTail) {
+				//oi_update has fallen behind, keep the distance travelled and drop the rest
+				oi_framesDropped++;
+				if(oi_streamDistanceOffset && oi_streamDistanceOffset + 1 < length)
+					oi_droppedDistance += (int16_t) ((frame[oi_streamDistanceOffset] << 8) | frame[oi_streamDistanceOffset + 1]);
+				break;
+			}
+			oi_frameLength[oi_frameHead] = length;
+			oi_frameHead = next;
+			break;
+		}
+	}
+}
+
 ///transmit character
 ///	internal function
 void oi_uartSendChar(char data)
@@ -406,19 +864,17 @@ void oi_uartSendChar(char data)
 	//timer_waitMicros(1000);
 }
 
+///Receive from UART, only while the sensor stream is paused
+///	internal function
 char oi_uartReceive(void)
 {
-	static int count = 0;
-	//uint32_t tempData; //used for error checking
 	char data;
 
-	while((UART4_FR_R & UART_FR_RXFE)); //wait here until data is recieved
-
-	data = (char)(UART4_DR_R & 0xFF);
+	while(oi_rawHead == oi_rawTail); //wait here until data is recieved by the interrupt
 
-	count++;
+	data = oi_raw[oi_rawTail];
+	oi_rawTail = (oi_rawTail + 1) % OI_RAW_SIZE;
 
-	//ToDo: Implement error checking
 	return data;
 }
 
@@ -455,6 +911,7 @@ char* oi_checkFirmware() {
 	uint16_t ptr;
 
 	//Reset the iRobot
+	oi_streamStop();
 	oi_uartSendChar(OI_OPCODE_RESET);
 
 	char c;
@@ -537,15 +994,15 @@ int getDegrees(oi_t *self){
 	//get distance moved in mm for the left and right wheel
 	// equation: ticks * (1/508)*72pi
 	//update the previous values to be correct
-	int distLeft = (self->leftEncoderCount - prevLeft)*(0.445265);
-	int distRight = (self->rightEncoderCount - prevRight)*(0.445265);
+	int distLeft = (self->leftEncoderCount - prevLeft)*(0.445265f);
+	int distRight = (self->rightEncoderCount - prevRight)*(0.445265f);
 	prevLeft = self->leftEncoderCount;
 	prevRight = self->rightEncoderCount;
 
 
 	//calculate the degree travelled by (right-left)/wheel base in mm
-	double deg = (distRight - distLeft)/178.5;//change 178.5 to improve accuracy of turning if needed
-	deg = (deg*180)/M_PI;
+	float deg = (distRight - distLeft)/178.5f;//change 178.5 to improve accuracy of turning if needed
+	deg = (deg*180)/(float)M_PI;
 
 	return (deg);
 
@@ -25,41 +25,64 @@
 
 #define M_PI 3.14159265358979323846
 
+///Sensor field groups for oi_setFieldMask
+#define OI_FIELDS_BUMP			0x0001	//wheel drops and bumps
+#define OI_FIELDS_CLIFF			0x0002	//cliff flags
+#define OI_FIELDS_WALL			0x0004	//wall, virtual wall and wall signal
+#define OI_FIELDS_CURRENT		0x0008	//overcurrent flags and motor currents
+#define OI_FIELDS_MISC			0x0010	//dirt, charging sources, oi mode, stream packets, stasis
+#define OI_FIELDS_IR			0x0020	//infrared characters
+#define OI_FIELDS_BUTTON		0x0040	//buttons
+#define OI_FIELDS_MOTION		0x0080	//distance, requested velocities and encoders, angle
+#define OI_FIELDS_BATTERY		0x0100	//charging state and battery
+#define OI_FIELDS_CLIFF_SIGNAL	0x0200	//cliff signals
+#define OI_FIELDS_SONG			0x0400	//song number and playing
+#define OI_FIELDS_LIGHT_BUMP	0x0800	//light bumper flags and signals
+#define OI_FIELDS_ALL			0xFFFF
+
+///Microseconds between stream frames
+#define OI_FRAME_PERIOD			15000
+
+///Stream frames that failed the length or checksum check
+extern volatile uint32_t oi_frameErrors;
+///Valid stream frames dropped because oi_update was not called in time
+extern volatile uint32_t oi_framesDropped;
+
 /// iRobot Create Sensor Data
 typedef struct {
-	//Boolean sensor values
-	uint32_t wheelDropLeft : 1;
-	uint32_t wheelDropRight : 1;
-	uint32_t bumpLeft : 1;
-	uint32_t bumpRight : 1;
-	uint32_t cliffLeft : 1;
-	uint32_t cliffFrontLeft : 1;
-	uint32_t cliffFrontRight : 1;
-	uint32_t cliffRight : 1;
-
-	uint32_t lightBumperRight : 1;
-	uint32_t lightBumperFrontRight : 1;
-	uint32_t lightBumperCenterRight : 1;
-	uint32_t lightBumperCenterLeft : 1;
-	uint32_t lightBumperFrontLeft : 1;
-	uint32_t lightBumperLeft : 1;
-
-	uint32_t wallSensor : 1;
-	uint32_t virtualWall : 1;
-
-	uint32_t overcurrentLeftWheel : 1;
-	uint32_t overcurrentRightWheel : 1;
-	uint32_t overcurrentMainBrush : 1;
-	uint32_t overcurrentSideBrush : 1;
-
-	uint32_t buttonClock : 1;
-	uint32_t buttonSchedule : 1;
-	uint32_t buttonDay : 1;
-	uint32_t buttonHour : 1;
-	uint32_t buttonMinute : 1;
-	uint32_t buttonDock : 1;
-	uint32_t buttonSpot : 1;
-	uint32_t buttonClean : 1;
+	//Boolean sensor values, 0 or 1
+	uint8_t wheelDropLeft;
+	uint8_t wheelDropRight;
+	uint8_t bumpLeft;
+	uint8_t bumpRight;
+	uint8_t cliffLeft;
+	uint8_t cliffFrontLeft;
+	uint8_t cliffFrontRight;
+	uint8_t cliffRight;
+
+	uint8_t lightBumperRight;
+	uint8_t lightBumperFrontRight;
+	uint8_t lightBumperCenterRight;
+	uint8_t lightBumperCenterLeft;
+	uint8_t lightBumperFrontLeft;
+	uint8_t lightBumperLeft;
+
+	uint8_t wallSensor;
+	uint8_t virtualWall;
+
+	uint8_t overcurrentLeftWheel;
+	uint8_t overcurrentRightWheel;
+	uint8_t overcurrentMainBrush;
+	uint8_t overcurrentSideBrush;
+
+	uint8_t buttonClock;
+	uint8_t buttonSchedule;
+	uint8_t buttonDay;
+	uint8_t buttonHour;
+	uint8_t buttonMinute;
+	uint8_t buttonDock;
+	uint8_t buttonSpot;
+	uint8_t buttonClean;
 
 	//Cliff sensors
 	uint16_t cliffLeftSignal;//0 to 4095 depending on color
@@ -88,8 +111,8 @@ typedef struct {
 	//Motion sensors
 	int16_t distance;
 	int16_t angle;
-	int8_t requestedVelocity;
-	int8_t requestedRadius;
+	int16_t requestedVelocity;
+	int16_t requestedRadius;
 	int16_t requestedRightVelocity;
 	int16_t requestedLeftVelocity;
 	uint16_t leftEncoderCount;        //here the encoder counts were made unsigned
@@ -133,8 +156,27 @@ void oi_init(oi_t *self);
 
 void oi_close();
 
-///Update sensor data
-void oi_update(oi_t *self);
+///Update sensor data from the frames streamed since the last call, does not wait
+///\return frames the Create sent since the last call, dropped ones included, 0 if the sensor data did not change
+int oi_update(oi_t *self);
+
+/// \brief Choose the sensor packets streamed to oi_update, by default all of group 100
+/// \param ids packet ids 7-58, or 100 for all of them, 43 must come before 44 for the angle to be calculated
+/// \param n number of ids, at most 16
+/// \return 0 on success, -1 if an id is unsupported or the packets do not fit in a stream frame
+int oi_setSensorList(const uint8_t *ids, uint8_t n);
+
+/// \brief Choose which oi_t fields the parser fills in, fields outside the mask keep their old value
+/// \param mask OR of OI_FIELDS_ groups, OI_FIELDS_ALL by default
+void oi_setFieldMask(uint16_t mask);
+
+/// \brief Measure parse time of a fresh group 100 packet with all fields and with the current field mask
+/// Prints cycles per parse to the LCD
+void oi_parseBench(oi_t *self);
+
+///Read the sensor list once with the query list opcode, waits for the reply
+///Pauses the sensor stream while it does if the stream is running
+void oi_query(oi_t *self);
 
 /// \brief Set the LEDS on the Create
 /// \param play_led 0=off, 1=on
@@ -148,6 +190,19 @@ void oi_setLeds(uint8_t play_led, uint8_t advance_led, uint8_t power_color, uint
 /// \param linear velocity in mm/s values range from -500 -> 500 of left wheel
 void oi_setWheels(int16_t right_wheel, int16_t left_wheel);
 
+/// \brief Drive straight until the Create has measured a distance on its own encoders, then stop
+/// The Create ends the motion itself with its script engine, but ignores every command, stop included, until it does.
+/// Only the original Create runs scripts, the Create 2 OI has no opcodes 152-158
+/// \param speed mm/s 0 -> 500
+/// \param distance mm, negative backwards
+void oi_driveDistance(int16_t speed, int16_t distance);
+
+/// \brief Turn in place until the Create has measured an angle on its own encoders, then stop
+/// Same script engine limits as oi_driveDistance
+/// \param speed mm/s of each wheel 0 -> 500
+/// \param angle degrees, positive counterclockwise
+void oi_turnAngle(int16_t speed, int16_t angle);
+
 
 /// \brief Load song sequence
 /// \param An integer value from 0 - 15 that acts as a label for note sequence
@@ -119,7 +119,7 @@ int ping_pulse() {
  * @return distance to nearby object in cm
  */
 int ping_read(){
-    return ping_pulse()*0.001071875;
+    return ping_pulse()*0.001071875f;
 }
 
 //part 1
@@ -148,7 +148,7 @@ void ping_test() {
     ping_init();
     while(1){
         int time = ping_pulse()/16;//microseconds
-        int dist = time*0.01715;//speed of sound in cm per us, divided by 2
+        int dist = time*0.01715f;//speed of sound in cm per us, divided by 2
         lcd_printf("time: %d us\ndist: %d cm\nOverflow: %d",time,dist,OF_count);
         timer_waitMillis(200);//send pulse every half second
     }
@@ -163,9 +163,9 @@ void ping_test() {
 int ping_check(){
     if(startTime != 0){
         if(endTime > startTime){
-            return (endTime - startTime)*0.001071875;
+            return (endTime - startTime)*0.001071875f;
         }else{
-            return ((endTime + 0x00FFFFFF) - startTime)*0.001071875;//account for overflow, 24 bit timer
+            return ((endTime + 0x00FFFFFF) - startTime)*0.001071875f;//account for overflow, 24 bit timer
         }
     } else
         return 0;
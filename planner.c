@@ -0,0 +1,316 @@
+/**
+ * @file planner.c
+ * @brief 8-connected A* path planning over a window of the grid, all memory is static
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+#include "planner.h"
+#include "Timer.h"
+#include <string.h>
+#include "stdlib.h"
+
+#define PLAN_START 15 //parent of the start cell
+#define PLAN_STEP_SHIFT 12 //the open set keeps the step that reached a cell above the 12 bits of the cell
+#define PLAN_CELL_MASK (PLAN_CELLS - 1)
+
+/// Open set entry, g is not kept since it is f less the distance left, which plan_left works out from the cell
+typedef struct {
+    uint16_t f;    //cost from the start plus the distance left
+    uint16_t cell; //window cell, y*PLAN_SIZE + x, with the step that reached it + 1 or PLAN_START above PLAN_STEP_SHIFT
+} plan_node_t;
+
+plan_point_t plan_path[PLAN_MAX_POINTS];
+int plan_points = 0;
+uint32_t plan_expanded = 0;
+uint32_t plan_peak = 0;
+uint32_t plan_time = 0;
+uint32_t plan_cost = 0;
+
+uint8_t plan_blocked[(PLAN_CELLS + 7) / 8]; //cells the cybot can't be in, one bit each
+uint8_t plan_open[(PLAN_CELLS + 7) / 8]; //cells pushed on the open set, one bit each
+uint8_t plan_closed[(PLAN_CELLS + 7) / 8]; //cells taken off it, their route is final
+//a nibble per cell, while the cell is open it is half its lowest f mod 16, once closed the step that reached it + 1
+//there is no room for a g per cell, but costs are even and an open cell's f is never more than 2*PLAN_DIAGONAL over the
+//f being expanded, so half of it mod 16 is enough to tell if a new route is cheaper, a cheaper route pushes the cell again
+//and the stale entry is skipped when it comes off
+uint8_t plan_nibble[(PLAN_CELLS + 1) / 2];
+plan_node_t plan_heap[PLAN_HEAP];
+int plan_heapSize;
+int plan_x0, plan_y0; //world cell of window cell 0
+int plan_gx, plan_gy; //window cell of the goal
+//steps to the 8 neighbours, sides first
+const int8_t plan_dx[8] = {1, 0, -1, 0, 1, -1, -1, 1};
+const int8_t plan_dy[8] = {0, 1, 0, -1, 1, 1, -1, -1};
+
+/**
+ * Nibble of a window cell
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param c window cell
+ * @return half its f mod 16 while open, the step that reached it + 1 or PLAN_START once closed
+ */
+static inline int plan_getNibble(int c){
+    return (plan_nibble[c >> 1] >> ((c & 1) << 2)) & 0xF;
+}
+/**
+ * Set the nibble of a window cell
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param c window cell
+ * @param v value, see plan_getNibble
+ */
+static inline void plan_setNibble(int c, int v){
+    plan_nibble[c >> 1] = (plan_nibble[c >> 1] & ~(0xF << ((c & 1) << 2))) | v << ((c & 1) << 2);
+}
+/**
+ * Check a window cell in a one bit per cell set
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param set plan_open or plan_closed
+ * @param c window cell
+ * @return nonzero if it is in the set
+ */
+static inline int plan_in(const uint8_t *set, int c){
+    return set[c >> 3] & (1 << (c & 7));
+}
+/**
+ * Add a window cell to a one bit per cell set
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param set plan_open or plan_closed
+ * @param c window cell
+ */
+static inline void plan_add(uint8_t *set, int c){
+    set[c >> 3] |= 1 << (c & 7);
+}
+/**
+ * Check if a window cell is blocked
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param c window cell
+ * @return nonzero if the cybot can't be there
+ */
+static inline int plan_isBlocked(int c){
+    return plan_blocked[c >> 3] & (1 << (c & 7));
+}
+/**
+ * Octile distance, the cost of the best path with no obstacles, never more than the real cost so A* stays optimal
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param dx cells along x
+ * @param dy cells along y
+ * @return cost
+ */
+static inline int plan_octile(int dx, int dy){
+    dx = abs(dx);
+    dy = abs(dy);
+    return dx > dy ? PLAN_STRAIGHT*dx + (PLAN_DIAGONAL - PLAN_STRAIGHT)*dy : PLAN_STRAIGHT*dy + (PLAN_DIAGONAL - PLAN_STRAIGHT)*dx;
+}
+/**
+ * Distance left from a window cell to the goal, PLAN_SIZE is a power of 2 so this is shifts and masks
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param c window cell
+ * @return octile distance to the goal
+ */
+static inline int plan_left(int c){
+    return plan_octile(plan_gx - c % PLAN_SIZE, plan_gy - c / PLAN_SIZE);
+}
+/**
+ * Order open set entries, lowest f first and the one further along on a tie, which keeps A* from fanning out across
+ * the many equally good paths in open space, further along is less distance left since g + left is the same
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param a entry
+ * @param b entry
+ * @return 1 if a comes before b
+ */
+static inline int plan_before(const plan_node_t *a, const plan_node_t *b){
+    return a->f < b->f || (a->f == b->f && plan_left(a->cell & PLAN_CELL_MASK) < plan_left(b->cell & PLAN_CELL_MASK));
+}
+/**
+ * Add an entry to the open set
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param n entry
+ * @return 1 if added, 0 if the open set is full
+ */
+int plan_push(const plan_node_t *n){
+    int i = plan_heapSize, up;
+    if(i == PLAN_HEAP)
+        return 0;
+    plan_heapSize++;
+    if(plan_heapSize > plan_peak)
+        plan_peak = plan_heapSize;
+    while(i > 0){//sift up
+        up = (i - 1) >> 1;
+        if(!plan_before(n, &plan_heap[up]))
+            break;
+        plan_heap[i] = plan_heap[up];
+        i = up;
+    }
+    plan_heap[i] = *n;
+    return 1;
+}
+/**
+ * Take the cheapest entry off the open set
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param n set to the entry
+ */
+void plan_pop(plan_node_t *n){
+    plan_node_t last = plan_heap[--plan_heapSize];
+    int i = 0, child;
+    *n = plan_heap[0];
+    while((child = 2*i + 1) < plan_heapSize){//sift the last entry down from the top
+        if(child + 1 < plan_heapSize && plan_before(&plan_heap[child + 1], &plan_heap[child]))
+            child++;
+        if(!plan_before(&plan_heap[child], &last))
+            break;
+        plan_heap[i] = plan_heap[child];
+        i = child;
+    }
+    plan_heap[i] = last;
+}
+/**
+ * Mark the window cells within PLAN_RADIUS of an object or hazard as blocked, only tiles that hold one are read
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void plan_markObstacles(void){
+    int n, cx, cy, x, y, dx, dy;
+    const grid_tile_t *t;
+    memset(plan_blocked, 0, sizeof(plan_blocked));
+    for(n = 0; n < GRID_TILES; n++){
+        t = &grid_tiles[n];
+        if(!t->used || !t->keep)
+            continue;
+        for(cy = 0; cy < GRID_TILE; cy++){
+            y = (t->ty << GRID_TILE_SHIFT) + cy - plan_y0;
+            if(y < -PLAN_RADIUS || y >= PLAN_SIZE + PLAN_RADIUS)
+                continue;
+            for(cx = 0; cx < GRID_TILE; cx++){
+                if(((t->cells[cy][cx >> 1] >> ((cx & 1) << 2)) & 0xF) <= GRID_FREE)
+                    continue;
+                x = (t->tx << GRID_TILE_SHIFT) + cx - plan_x0;
+                for(dy = -PLAN_RADIUS; dy <= PLAN_RADIUS; dy++)
+                    for(dx = -PLAN_RADIUS; dx <= PLAN_RADIUS; dx++)
+                        if(dx*dx + dy*dy <= PLAN_RADIUS*PLAN_RADIUS + 1 && x + dx >= 0 && x + dx < PLAN_SIZE && y + dy >= 0 && y + dy < PLAN_SIZE)
+                            plan_blocked[((y + dy)*PLAN_SIZE + x + dx) >> 3] |= 1 << (((y + dy)*PLAN_SIZE + x + dx) & 7);
+            }
+        }
+    }
+}
+/**
+ * Walk back from the goal along the parents and keep the cells where the direction changes
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param goal window cell of the goal
+ * @return number of waypoints stored
+ */
+int plan_trace(int goal){
+    int pass, c, p, last, count = 0, i = 0;
+    for(pass = 0; pass < 2; pass++){//count first so the waypoints can be stored start first
+        c = goal;
+        last = -1;
+        i = count;
+        while((p = plan_getNibble(c)) != PLAN_START){
+            if(p != last){//the goal and every turn
+                if(pass == 0)
+                    count++;
+                else if(--i < PLAN_MAX_POINTS){
+                    plan_path[i].x = plan_x0 + c % PLAN_SIZE;
+                    plan_path[i].y = plan_y0 + c / PLAN_SIZE;
+                }
+                last = p;
+            }
+            c -= plan_dy[p - 1]*PLAN_SIZE + plan_dx[p - 1];
+        }
+    }
+    return count < PLAN_MAX_POINTS ? count : PLAN_MAX_POINTS;
+}
+/**
+ * Plan the shortest path with A*, cells that are unexplored are assumed free so the cybot can plan into the unknown
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x0 start cell column
+ * @param y0 start cell row
+ * @param x1 goal cell column
+ * @param y1 goal cell row
+ * @return number of waypoints in plan_path, or PLAN_FAR, PLAN_BLOCKED, PLAN_NONE or PLAN_FULL
+ */
+int plan_find(int x0, int y0, int x1, int y1){
+    uint32_t start = timer_now();
+    plan_node_t n, next;
+    int sx, sy, g, goal, d, x, y, c, cell, result = PLAN_NONE;
+    plan_expanded = 0;
+    plan_peak = 0;
+    plan_points = 0;
+    plan_cost = 0;
+    if(abs(x1 - x0) > PLAN_SIZE - 1 || abs(y1 - y0) > PLAN_SIZE - 1)
+        return PLAN_FAR;
+    //center the window on start and goal so there is room to go around things, split the spare cells so that both
+    //always land in [0,PLAN_SIZE) whatever the parity of the distance between them
+    plan_x0 = (x0 < x1 ? x0 : x1) - (PLAN_SIZE - 1 - abs(x1 - x0))/2;
+    plan_y0 = (y0 < y1 ? y0 : y1) - (PLAN_SIZE - 1 - abs(y1 - y0))/2;
+    sx = x0 - plan_x0;
+    sy = y0 - plan_y0;
+    plan_gx = x1 - plan_x0;
+    plan_gy = y1 - plan_y0;
+    goal = plan_gy*PLAN_SIZE + plan_gx;
+    plan_markObstacles();
+    if(plan_isBlocked(goal)){
+        plan_time = timer_elapsed(start);
+        return PLAN_BLOCKED;
+    }
+    plan_blocked[(sy*PLAN_SIZE + sx) >> 3] &= ~(1 << ((sy*PLAN_SIZE + sx) & 7));//it may have to back away from a wall
+    memset(plan_open, 0, sizeof(plan_open));
+    memset(plan_closed, 0, sizeof(plan_closed));
+    plan_heapSize = 0;
+    n.cell = sy*PLAN_SIZE + sx;
+    n.f = plan_left(n.cell);
+    plan_add(plan_open, n.cell);
+    n.cell |= PLAN_START << PLAN_STEP_SHIFT;
+    plan_push(&n);
+    while(plan_heapSize){
+        plan_pop(&n);
+        cell = n.cell & PLAN_CELL_MASK;
+        if(plan_in(plan_closed, cell))
+            continue;//a stale entry, the cell was closed by a cheaper one
+        plan_add(plan_closed, cell);
+        plan_setNibble(cell, n.cell >> PLAN_STEP_SHIFT);
+        plan_expanded++;
+        g = n.f - plan_left(cell);
+        if(cell == goal){
+            plan_cost = g;
+            result = plan_points = plan_trace(goal);
+            break;
+        }
+        x = cell % PLAN_SIZE;
+        y = cell / PLAN_SIZE;
+        for(d = 0; d < 8; d++){
+            if(x + plan_dx[d] < 0 || x + plan_dx[d] >= PLAN_SIZE || y + plan_dy[d] < 0 || y + plan_dy[d] >= PLAN_SIZE)
+                continue;
+            c = cell + plan_dy[d]*PLAN_SIZE + plan_dx[d];
+            if(plan_isBlocked(c) || plan_in(plan_closed, c))
+                continue;
+            //no cutting corners, both side cells of a diagonal step must be clear
+            if(d >= 4 && (plan_isBlocked(cell + plan_dx[d]) || plan_isBlocked(cell + plan_dy[d]*PLAN_SIZE)))
+                continue;
+            next.f = g + (d < 4 ? PLAN_STRAIGHT : PLAN_DIAGONAL) + plan_left(c);
+            //both f are between n.f and n.f + 2*PLAN_DIAGONAL, so halved and taken from n.f they fit in 4 bits
+            if(plan_in(plan_open, c) && (next.f - n.f) >> 1 >= ((plan_getNibble(c) - (n.f >> 1)) & 0xF))
+                continue;//already open by a route at least as cheap
+            plan_add(plan_open, c);
+            plan_setNibble(c, (next.f >> 1) & 0xF);
+            next.cell = c | (d + 1) << PLAN_STEP_SHIFT;
+            if(!plan_push(&next)){
+                result = PLAN_FULL;
+                plan_heapSize = 0;
+                break;
+            }
+        }
+    }
+    plan_time = timer_elapsed(start);
+    return result;
+}
@@ -0,0 +1,53 @@
+/**
+ * @file planner.h
+ * @brief 8-connected A* path planning over a window of the grid, all memory is static
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+
+#ifndef PLANNER_H_
+#define PLANNER_H_
+
+#include <stdint.h>
+#include "grid.h"
+
+#define PLAN_SIZE 64 //cells along each side of the window searched, start and goal must both be in it
+#define PLAN_CELLS (PLAN_SIZE*PLAN_SIZE)
+#define PLAN_HEAP 800 //open set entries, 4 bytes each, a cell found a cheaper route is pushed again, the search fails
+                      //with PLAN_FULL if it needs more
+#define PLAN_RADIUS 2 //cells of clearance kept from objects and hazards, the cybot is about 3.5 dm across
+#define PLAN_MAX_POINTS 32 //waypoints kept, a longer path keeps its first PLAN_MAX_POINTS
+#define PLAN_STRAIGHT 10 //cost of a step to a side neighbour
+#define PLAN_DIAGONAL 14 //cost of a step to a corner neighbour, 10*sqrt(2)
+
+//plan_find results besides a waypoint count
+#define PLAN_FAR -1     //start and goal don't fit in one window
+#define PLAN_BLOCKED -2 //goal is an obstacle or too close to one
+#define PLAN_NONE -3    //no path in the window
+#define PLAN_FULL -4    //open set overflowed
+
+/// A cell on the planned path
+typedef struct {
+    int16_t x, y;
+} plan_point_t;
+
+extern plan_point_t plan_path[PLAN_MAX_POINTS]; //cells where the path changes direction, ending with the goal
+extern int plan_points;
+extern uint32_t plan_expanded; //cells closed by the last search, stale entries skipped are not counted
+extern uint32_t plan_peak; //most entries the open set held during the last search, keep it well under PLAN_HEAP
+extern uint32_t plan_time; //us the last search took, including marking obstacles
+extern uint32_t plan_cost; //length of the last path in tenths of a cell
+
+/**
+ * Plan the shortest path with A*, cells that are unexplored are assumed free so the cybot can plan into the unknown
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x0 start cell column
+ * @param y0 start cell row
+ * @param x1 goal cell column
+ * @param y1 goal cell row
+ * @return number of waypoints in plan_path, or PLAN_FAR, PLAN_BLOCKED, PLAN_NONE or PLAN_FULL
+ */
+int plan_find(int x0, int y0, int x1, int y1);
+
+#endif /* PLANNER_H_ */
@@ -19,31 +19,115 @@
 #include "movement.h"
 #include "open_interface.h"
 #include "object_detect.h"
+#include "scheduler.h"
+#include "sweep.h"
+#include "grid.h"
+#include "occupancy.h"
+#include "map.h"
+#include "fixmath.h"
+#include "bench.h"
+#include "telemetry.h"
+#include "store.h"
+#include "frontier.h"
+#include "planner.h"
+#include "odometry.h"
+#include "control.h"
+#include "ekf.h"
+#include <math.h>
 
 //to calibrate: ir,servo,cliffSignal,oi_angle,oi_cliffSignal,wheel_speed,
 
-#define rad 0.017453292519943
 #define mSpeed 100
-#define tSpeed 40
-#define edgeThresh 2640 //determine better values for these via testing, may need more specialized values for each sensor
-#define hype 47 //diagonal across rectangular grid, must be measured before testing
-/*
-    blank ' '
-    roomba 'R'
-    object 'B'
-    cliff 'C'
-    edge 'G'
-    unexplored '*'
-*/
-char map[2*hype][2*hype];
+#define tRate 20 //deg/s, about 40 mm/s at each wheel
+#define IR_RANGE 80 //cm, ir readings further than this are not trusted
+#define RAY_STEP 2 //degrees between rays cast from a sweep, a cell is 7 degrees wide at IR_RANGE
+#define hype (GRID_WIDTH/2) //half the map window draw_map renders around the cybot, set the window and world size in grid.h
+
+//task periods and deadlines in ms, hazard reaction time is at most SENSOR_PERIOD plus the hazard task runtime
+#define SENSOR_PERIOD 15 //open interface streams a sensor frame every 15 ms
+#define SENSOR_DEADLINE 5
+#define HAZARD_PERIOD 15
+#define HAZARD_DEADLINE 15
+#define CONTROL_PERIOD 15 //once per sensor frame, after the hazard task has had a chance to stop
+#define CONTROL_DEADLINE 5
+#define COMMAND_PERIOD 20
+#define COMMAND_DEADLINE 20
+#define TELEMETRY_PERIOD 500
+#define TELEMETRY_DEADLINE 100
+#define LCD_PERIOD 250
+#define LCD_DEADLINE 100
+#define OUTPUT_PERIOD 20
+#define OUTPUT_DEADLINE 10
+#define SCAN_PERIOD 1 //servo steps take 5 ms and ir samples arrive every 1 ms
+#define SCAN_DEADLINE 1
+
+#define MAP_LINES (2*hype+2) //map rows plus top and bottom border
+#define MAP_LINE_SIZE (2*hype+6) //longest rendered map line, the top border starts with an extra newline
+#define SCAN_LINE_SIZE (SWEEP_LINE_SIZE+18) //longest scan record line, the first has the column headings
+//map cells are in grid.h, the robot is drawn as 'R'
 char str[100];
-volatile double xPos;//cords work however we want so 0,0 is bottom left, its, (x,y) and +y is up and +x is right
-volatile double yPos;//in dm decimeter (1/10 m)
-volatile double heading;//ccw from +x direction in degrees
-volatile double distanceDelta;
-volatile double angleDelta;
+int edgeThresh = 2640; //determine better values for these via testing, may need more specialized values for each sensor, saved with 'e'
+/// Per cybot constants saved in the STORE_CAL region, loaded at boot over the compiled in defaults
+typedef struct {
+    int32_t irCali;
+    int32_t zeroOffset;
+    float servoDelta;
+    int32_t edgeThresh;
+} calibration_t;
+/// Cybot pose saved in the STORE_POSE region
+typedef struct {
+    float x, y, heading;
+} pose_t;
+//copy of the odometry pose refreshed every sensor frame, set it with odo_set
+volatile float xPos;//cords work however we want so 0,0 is bottom left, its, (x,y) and +y is up and +x is right
+volatile float yPos;//in dm decimeter (1/10 m)
+volatile float heading;//ccw from +x direction in degrees
 volatile int moving; //0 or 1 conditional
 volatile int turning;
+oi_t *sensor_data;
+const uint8_t sensorList[] = {7, 9, 10, 11, 12, 19, 25, 26, 28, 29, 30, 31, 43, 44};
+char input = '~';
+int telemetry = 0;//periodic status reports, toggled with 't'
+int binary = 0;//reports go out as telemetry.h frames instead of text, toggled with 'n'
+int mapLine = -1;//next line of a background map dump, -1 when idle
+int mapX = 0, mapY = 0;//bottom left cell of the map window being dumped
+int deltaTile = -1;//next tile to check for a background map update, -1 when idle
+sweep_t scan;//record of the last 'c' scan
+int objects[64];//objects found in it, see scan_objects
+int scanning = 0;
+int scanOutput = 0;//send every scan record, toggled with 'p'
+int scanLine = -1;//next line of a background scan record dump, -1 when idle
+char argCommand = 0;//command reading a line of arguments, 0 when none
+char argLine[24];//arguments typed so far
+int argLen;//characters in argLine
+
+//scheduler tasks, defined after main
+void task_sensors();
+void task_hazards();
+void task_control();
+void task_commands();
+void task_telemetry();
+void task_lcd();
+void task_output();
+void task_scan();
+void scan1_finish(int *s);
+void scan_landmarks(const int *s);
+void map_scan(const sweep_t *rec);
+void scan_cell(int dist, int ang, int *x, int *y);
+void pose_set(float x, float y, float h);
+void draw_mathBench();
+void draw_tasks();
+int draw_mapLine(int n, char *line);
+void draw_mapWindow();
+void run_command(char input);
+void report_hazard(int kind, int sides);
+void checkpoint_save();
+void checkpoint_load();
+void draw_frontiers();
+void arg_receive(char c);
+void goal_command(const char *args);
+void gains_command(const char *args);
+void draw_plan(int x, int y);
 /**
  * Main method for project execution
  * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
@@ -51,226 +135,632 @@ volatile int turning;
  */
 void main()
 {
+    //single precision fpu with lazy stacking, interrupts that don't use it don't pay to save its registers
+    NVIC_CPAC_R |= NVIC_CPAC_CP10_FULL | NVIC_CPAC_CP11_FULL;//_c_int00 already does this, but be explicit
+    NVIC_FPCC_R |= NVIC_FPCC_ASPEN | NVIC_FPCC_LSPEN;
+
     //initialize cybot
     servo_init();
     lcd_init();
     ping_init();
     ir_init();
-    oi_t *sensor_data = oi_alloc();
+    sensor_data = oi_alloc();
     oi_init(sensor_data);
+    //only stream the packets the tasks use: bumps, cliffs, distance, battery, cliff signals and encoders
+    oi_setSensorList(sensorList, sizeof(sensorList));
+    oi_setFieldMask(OI_FIELDS_BUMP | OI_FIELDS_CLIFF | OI_FIELDS_CLIFF_SIGNAL | OI_FIELDS_MOTION | OI_FIELDS_BATTERY);
+    oi_query(sensor_data);//one reading of the new list, the battery report below doesn't wait on a stream frame
     uart_init();
 
     oi_setWheels(0,0);
-    servo_setAngle(90);
+    servo_moveTo(90);//centers while the rest of init runs
 
     moving  = 0;
     turning = 0;
-    heading = 90;
-    distanceDelta = 0;
-    angleDelta = 0;
-    xPos = hype;
-    yPos = hype;
+    pose_set(GRID_ORIGIN, GRID_ORIGIN, 90);//middle of the world, it can be explored in any direction
 
     map_init();
     music_init();
+    if(store_init())
+        checkpoint_load();//carry on where a reset left off
+    else
+        uart_sendStr("\r\nEEPROM unusable, starting fresh");
 
-    char input = '~';
-    int danger;
     //indicate when cybot is ready for user input
     sprintf(str,"\r\nInitialized!\r\nBattery at %d/%d\r\n",sensor_data->batteryCharge,sensor_data->batteryCapacity);
     uart_sendStr(str);
-    //primary while loop
-    while(1){
-        //update open interface sensor
-        oi_update(sensor_data);
-        if(button_getButton() == 6){
-            oi_free(sensor_data);
-            exit(0);
+
+    //tasks released in the same tick run in this order, so hazards always see the newest sensor frame
+    sched_init();
+    sched_addTask("sensor", task_sensors, SENSOR_PERIOD, SENSOR_DEADLINE);
+    sched_addTask("hazard", task_hazards, HAZARD_PERIOD, HAZARD_DEADLINE);
+    sched_addTask("control", task_control, CONTROL_PERIOD, CONTROL_DEADLINE);
+    sched_addTask("command", task_commands, COMMAND_PERIOD, COMMAND_DEADLINE);
+    sched_addTask("telemetry", task_telemetry, TELEMETRY_PERIOD, TELEMETRY_DEADLINE);
+    sched_addTask("lcd", task_lcd, LCD_PERIOD, LCD_DEADLINE);
+    sched_addTask("output", task_output, OUTPUT_PERIOD, OUTPUT_DEADLINE);
+    sched_addTask("scan", task_scan, SCAN_PERIOD, SCAN_DEADLINE);
+    //primary loop, returns when the exit button is pressed
+    sched_run();
+
+    oi_free(sensor_data);
+    exit(0);
+}
+/**
+ * Sensor task, read the open interface frames received since the last run and integrate the wheel movement into the pose
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void task_sensors(){
+    odo_pose_t pose;
+    int frames;
+    //update open interface sensor
+    frames = oi_update(sensor_data);
+    if(frames){//the task and the stream drift, some periods bring no frame and the next brings two
+        odo_update(sensor_data->leftEncoderCount, sensor_data->rightEncoderCount, frames);//counts are absolute, merged frames still add up
+        odo_get(&pose);
+        ekf_predict(&pose, odo_step, odo_stepTurn);
+        xPos = pose.x;
+        yPos = pose.y;
+        heading = pose.heading;
+    }
+    if(button_getButton() == 6)
+        sched_stop();
+}
+/**
+ * Control task, run the wheel and heading loops on the newest sensor frame and report motions once they finish
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void task_control(){
+    ctrl_update();
+    if((moving || turning) && ctrl_mode == CTRL_IDLE){
+        moving = 0;
+        turning = 0;
+        update_position();
+    }
+}
+/**
+ * Hazard task, stop the cybot and mark the map when ping, cliff, edge or bump sensors trigger
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void task_hazards(){
+    int danger;
+    if(moving ==1 && ping_check()){
+        if(ping_check() <= 20){
+            ctrl_stop();
+            input = ' ';
+            report_hazard(TELE_HAZARD_PING, 0);
         }
-        if(!(UART1_FR_R & UART_FR_RXFE)){//TEST THIS
-            input = (char)(UART1_DR_R & 0xFF);
-            uart_sendChar(input);
+        ping_sendPulse();
+        ping_ready();
+    }
+    if(moving==1 && check_cliff(sensor_data)){
+        ctrl_stop();
+        danger =  check_cliff(sensor_data);
+        report_hazard(TELE_HAZARD_CLIFF, danger);
+        grid_mark((int)xPos, (int)yPos, GRID_CLIFF);
+        input = ' ';
+    }
+    if(moving==1 && check_edge(sensor_data)){
+        ctrl_stop();
+        danger = check_edge(sensor_data);
+        report_hazard(TELE_HAZARD_EDGE, danger);
+        grid_mark((int)xPos, (int)yPos, GRID_EDGE);
+        input = ' ';
+    }
+    if(moving==1 && check_bump(sensor_data)){
+        ctrl_stop();
+        danger = check_bump(sensor_data);
+        report_hazard(TELE_HAZARD_BUMP, ((danger & 0x2) << 2) | (danger & 0x1));//left and right line up with the cliff sensors
+        grid_mark((int)xPos, (int)yPos, GRID_BUMP);
+        input = ' ';
+    }
+}
+/**
+ * Report a hazard as text or a TELE_HAZARD frame
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param kind TELE_HAZARD_PING, TELE_HAZARD_CLIFF, TELE_HAZARD_EDGE or TELE_HAZARD_BUMP
+ * @param sides sensors that triggered, {L,FL,FR,R} as bits 3 to 0
+ */
+void report_hazard(int kind, int sides){
+    static const char *names[] = {"\r\nobject imminent", "\r\ncliff detected at: ", "\r\nedge detected at: ", "\r\nbump detected! "};
+    int len;
+    if(binary){
+        tele_hazard(kind, sides, xPos, yPos);
+        return;
+    }
+    len = sprintf(str,"%s",names[kind]);
+    if(sides & 0x8)
+        len += sprintf(str+len,"Left, ");
+    if(sides & 0x4)
+        len += sprintf(str+len,"Front Left, ");
+    if(sides & 0x2)
+        len += sprintf(str+len,"Front Right, ");
+    if(sides & 0x1)
+        len += sprintf(str+len,"Right, ");
+    uart_sendStr(str);
+}
+/**
+ * Command task, act on stops requested by the hazard task and every byte the operator has sent
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void task_commands(){
+    char c;
+    if(input != '~'){
+        run_command(input);
+        input = '~';
+    }
+    while(uart_tryReceive(&c)){//bytes wait in the uart receive buffer while other work runs
+        uart_sendChar(c);
+        if(c == ' '){//emergency stop always runs, even part way through a line of arguments
+            argCommand = 0;
+            run_command(c);
         }
-        if(moving ==1 && ping_check()){
-            if(ping_check() <= 20){
-                oi_setWheels(0,0);
-                input = ' ';
-                sprintf(str,"\r\nobject imminent");
-                uart_sendStr(str);
+        else if(argCommand)
+            arg_receive(c);
+        else
+            run_command(c);
+    }
+}
+/**
+ * Act on a single operator command
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param input command character
+ */
+void run_command(char input){
+    switch(input){
+        case 'w' :
+            if(!moving && !turning && !scanning){//the sweep owns the ping sensor
+                update_position();
+                ctrl_drive(mSpeed);
+                moving = 1;
+                //maybe send a putty message
             }
-            ping_sendPulse();
-            ping_ready();
-        }
-        if(moving==1 && check_cliff(sensor_data)){
-            oi_setWheels(0,0);
-            danger =  check_cliff(sensor_data);
-			sprintf(str,"\r\ncliff detected at: ");
-			if(danger & 0x8)
-			    sprintf(str,"%sLeft, ",str);
-            if(danger & 0x4)
-                sprintf(str,"%sFront Left, ",str);
-            if(danger & 0x2)
-                sprintf(str,"%sFront Right, ",str);
-            if(danger & 0x1)
-                sprintf(str,"%sRight, ",str);
-			uart_sendStr(str);
-			map[(int)xPos][(int)yPos] = 'C';
-			input = ' ';
-		}
-        if(moving==1 && check_edge(sensor_data)){
-            oi_setWheels(0,0);
-            danger = check_edge(sensor_data);
-            sprintf(str,"\r\nedge detected at: ");
-            if(danger & 0x8)
-                sprintf(str,"%sLeft, ",str);
-            if(danger & 0x4)
-                sprintf(str,"%sFront Left, ",str);
-            if(danger & 0x2)
-                sprintf(str,"%sFront Right, ",str);
-            if(danger & 0x1)
-                sprintf(str,"%sRight, ",str);
+            break;
+        case 'a' :
+            if(!moving && !turning && !scanning){//the sweep owns the ping sensor
+                update_position();
+                ctrl_rotate(tRate);
+                turning = 1;
+            }
+            break;
+        case 's' :
+            if(!moving && !turning && !scanning){//the sweep owns the ping sensor
+                update_position();
+                ctrl_drive(-mSpeed);
+                moving = 2;//used in danger detection
+            }
+            break;
+        case 'd' :
+            if(!moving && !turning && !scanning){//the sweep owns the ping sensor
+                update_position();
+                ctrl_rotate(-tRate);
+                turning = 1;
+            }
+            break;
+        case ' ' ://movement so far was already accumulated by the sensor task
+            moving = 0;
+            if(turning)
+                ctrl_turn(0);//settle on the heading it stopped at, task_control reports once it is there
+            else{
+                ctrl_stop();
+                update_position();
+            }
+            break;
+        case 'c' :
+            if(!moving && !turning && !scanning)
+                scan1();//task_scan finishes it
+            break;
+        case 'p' :
+            scanOutput = !scanOutput;
+            break;
+        case 'v' :
+            scan2();
+            break;
+        case 'z' :
+            if(mapLine < 0){
+                draw_mapWindow();
+                mapLine = 0;//task_output sends it without stalling the other tasks
+            }
+            break;
+        case 'u' :
+            if(deltaTile < 0)
+                deltaTile = 0;//only the rows changed since the last update
+            break;
+        case 'y' :
+            grid_markAllDirty();//resend every row, for a viewer that just connected
+            if(deltaTile < 0)
+                deltaTile = 0;
+            break;
+        case 'x' :
+            draw_heading();
+        case 'l':
+            lcd_printf("please love me");
+            break;
+        case 'm':
+            //play music
+            oi_play_song(1);
+            break;
+        case 'b' :
+            if(binary){
+                tele_battery(sensor_data->batteryCharge,sensor_data->batteryCapacity);
+                break;
+            }
+            sprintf(str,"\r\nBattery at %d/%d",sensor_data->batteryCharge,sensor_data->batteryCapacity);
             uart_sendStr(str);
-            map[(int)xPos][(int)yPos] = 'G';
-            input = ' ';
+            break;
+        case 'n' :
+            binary = !binary;
+            break;
+        case 'e' :
+            checkpoint_save();
+            break;
+        case 'h' :
+            draw_frontiers();
+            break;
+        //arguments are separated by commas, a space is still the emergency stop
+        case 'g' ://"gx,y" plans to cell (x,y), a bare 'g' to the best frontier
+        case 'r' ://"rdeg" turns by deg ccw, negative cw
+        case 'i' ://"imm" drives mm forward, negative back
+        case 'j' ://"jw,kp,ki,kd" or "jh,kp,ki,kd" sets the wheel or heading gains, a bare 'j' lists them
+            argCommand = input;
+            argLen = 0;
+            break;
+        case 'q' ://new arena, forget the map and start over at the origin
+            if(moving || turning || scanning)
+                break;
+            map_init();
+            pose_set(GRID_ORIGIN, GRID_ORIGIN, 90);
+            checkpoint_save();
+            break;
+        case 't' :
+            telemetry = !telemetry;
+            break;
+        case 'o' :
+            draw_tasks();
+            break;
+        case 'k' :
+            fix_bench();
+            break;
+        case 'f' :
+            draw_mathBench();
+            break;
+        case 'B' ://sensor packet parse time on the lcd, pauses the stream so only while standing still
+            if(moving || turning || scanning)
+                break;
+            oi_parseBench(sensor_data);
+            break;
+    }
+}
+/**
+ * Telemetry task, backup beep and periodic position reports when enabled
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void task_telemetry(){
+    if(moving == 2)
+        oi_play_song(2);
+    if(telemetry && binary){
+        tele_pose(xPos,yPos,heading,sched_millis());
+        tele_battery(sensor_data->batteryCharge,sensor_data->batteryCapacity);
+    }
+    else if(telemetry){
+        sprintf(str,"\r\nT %d ms (%.2lf,%.2lf) %.0lf deg %d/%d",(int)sched_millis(),xPos,yPos,heading,sensor_data->batteryCharge,sensor_data->batteryCapacity);
+        uart_sendStr(str);
+    }
+}
+/**
+ * LCD task, show battery level
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void task_lcd(){
+    //lcd_printf("L: %d\nFL: %d\nFR: %d\nR: %d",sensor_data->cliffLeftSignal,sensor_data->cliffFrontLeftSignal,sensor_data->cliffFrontRightSignal,sensor_data->cliffRightSignal);
+    lcd_printf("Battery: %d/%d",sensor_data->batteryCharge,sensor_data->batteryCapacity);
+}
+/**
+ * Report run count, overruns and worst execution time of each scheduler task, then uart and open interface errors
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void draw_tasks(){
+    int n;
+    const task_t *t;
+    sprintf(str,"\r\nTask\tPeriod\tRuns\tOverrun\tWorst us");
+    uart_sendStr(str);
+    for(n = 0; n < sched_numTasks(); n++){
+        t = sched_getTask(n);
+        sprintf(str,"\r\n%s\t%d\t%d\t%d\t%d",t->name,(int)t->period,(int)t->runs,(int)t->overruns,(int)t->worst);
+        uart_sendStr(str);
+    }
+    sprintf(str,"\r\nUart overrun %d framing %d dropped %d",(int)uart_overrunErrors,(int)uart_framingErrors,(int)uart_rxDropped);
+    uart_sendStr(str);
+    sprintf(str,"\r\nOI frame errors %d dropped %d",(int)oi_frameErrors,(int)oi_framesDropped);
+    uart_sendStr(str);
+    sprintf(str,"\r\nMap tiles %d/%d evicted %d dropped %d",grid_tilesUsed(),GRID_TILES,(int)grid_evictions,(int)grid_dropped);
+    uart_sendStr(str);
+}
+/**
+ * List the frontiers between explored and unexplored space, best first
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void draw_frontiers(){
+    int n;
+    frontier_update((int)xPos, (int)yPos);
+    if(!frontier_count)
+        uart_sendStr("\r\nNo frontiers, everything reachable is explored");
+    for(n = 0; n < frontier_count; n++){
+        sprintf(str,"\r\nFrontier %d: (%d,%d) %d cells, %d away",n,frontiers[n].x,frontiers[n].y,frontiers[n].size,frontiers[n].dist);
+        uart_sendStr(str);
+    }
+}
+/**
+ * Collect the arguments of a 'g', 'r', 'i' or 'j' command until the end of the line, then run it
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param c character received
+ */
+void arg_receive(char c){
+    float amount;
+    if(c != '\r' && c != '\n'){
+        if(argLen < (int)sizeof(argLine) - 1)
+            argLine[argLen++] = c;
+        return;
+    }
+    argLine[argLen] = 0;
+    switch(argCommand){
+        case 'g' :
+            goal_command(argLine);
+            break;
+        case 'r' :
+            if(sscanf(argLine, "%f", &amount) == 1 && !moving && !turning && !scanning){
+                update_position();
+                ctrl_turn(amount);
+                turning = 1;//task_control reports once the turn is done
+            }
+            break;
+        case 'i' :
+            if(sscanf(argLine, "%f", &amount) == 1 && !moving && !turning && !scanning){
+                update_position();
+                ctrl_move(amount, mSpeed);
+                moving = amount < 0 ? 2 : 1;//task_control reports once it is there
+            }
+            break;
+        case 'j' :
+            gains_command(argLine);
+            break;
+    }
+    argCommand = 0;
+}
+/**
+ * Plan to the cell given, or to the best frontier if there is none
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param args "x,y" or empty
+ */
+void goal_command(const char *args){
+    int x, y;
+    const frontier_t *f;
+    if(sscanf(args, "%d,%d", &x, &y) == 2){
+        draw_plan(x, y);
+        return;
+    }
+    frontier_update((int)xPos, (int)yPos);
+    f = frontier_best();
+    if(!f){
+        uart_sendStr("\r\nNo frontier to plan to");
+        return;
+    }
+    draw_plan(f->x, f->y);
+}
+/**
+ * Set the gains of the wheel or heading loops, then list them all
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param args "w,kp,ki,kd", "h,kp,ki,kd" or empty
+ */
+void gains_command(const char *args){
+    char loop;
+    float kp, ki, kd;
+    if(sscanf(args, "%c,%f,%f,%f", &loop, &kp, &ki, &kd) == 4){
+        if(loop == 'w'){
+            ctrl_wheel[0].kp = ctrl_wheel[1].kp = kp;
+            ctrl_wheel[0].ki = ctrl_wheel[1].ki = ki;
+            ctrl_wheel[0].kd = ctrl_wheel[1].kd = kd;
         }
-        if(moving==1 && check_bump(sensor_data)){
-            oi_setWheels(0,0);
-            danger = check_bump(sensor_data);
-            sprintf(str,"\r\nbump detected! ");
-            if(danger & 0x2)
-                sprintf(str,"%sLeft, ",str);
-            if(danger & 0x1)
-                sprintf(str,"%sRight, ",str);
-            uart_sendStr(str);
-            map[(int)xPos][(int)yPos] = 'L';
-            input = ' ';
+        if(loop == 'h'){
+            ctrl_heading.kp = kp;
+            ctrl_heading.ki = ki;
+            ctrl_heading.kd = kd;
         }
-		if(input != '~'){
-			switch(input){
-				case 'w' :
-					if(!moving && !turning){
-					    update_position();
-						oi_setWheels(mSpeed, mSpeed);
-						moving = 1;
-						//maybe send a putty message
-					}
-					break;
-				case 'a' :
-					if(!moving && !turning){
-					    update_position();
-						oi_setWheels(tSpeed,-tSpeed);
-						turning = 1;
-					}
-					break;
-				case 's' :
-					if(!moving && !turning){
-					    update_position();
-						oi_setWheels(-mSpeed,-mSpeed);
-						moving = 2;//used in danger detection
-					}
-					break;
-				case 'd' :
-					if(!moving && !turning){
-					    update_position();
-						oi_setWheels(-tSpeed,tSpeed);
-						turning = 1;
-					}
-					break;
-				case ' ' :
-					oi_setWheels(0, 0);
-					if(moving){
-						distanceDelta += sensor_data->distance;//convert mm to dm
-						moving = 0;
-					}
-					if(turning){
-						angleDelta += sensor_data->angle;
-						turning = 0;
-					}
-					update_position();
-					break;
-				case 'c' :
-					if(!moving && !turning)
-						scan1();
-					break;
-				case 'v' :
-				    scan2();
-				    break;
-				case 'z' :
-				    draw_map();
-				    break;
-				case 'x' :
-				    draw_heading();
-				case 'l':
-					lcd_printf("please love me");
-					break;
-				case 'm':
-					//play music
-				    oi_play_song(1);
-					break;
-				case 'b' :
-				    sprintf(str,"\r\nBattery at %d/%d",sensor_data->batteryCharge,sensor_data->batteryCapacity);
-				    uart_sendStr(str);
-			}
-			input = '~';
-		}
-		if(moving)
-		    distanceDelta += sensor_data->distance;
-		if(turning)
-		    angleDelta += sensor_data->angle;
-		if(moving == 2)
-		    oi_play_song(2);
-
-
-		//lcd_printf("L: %d\nFL: %d\nFR: %d\nR: %d",sensor_data->cliffLeftSignal,sensor_data->cliffFrontLeftSignal,sensor_data->cliffFrontRightSignal,sensor_data->cliffRightSignal);
-		lcd_printf("Battery: %d/%d",sensor_data->batteryCharge,sensor_data->batteryCapacity);
     }
-
-
+    snprintf(str,sizeof(str),"\r\nWheel kp %.2lf ki %.2lf kd %.3lf",ctrl_wheel[0].kp,ctrl_wheel[0].ki,ctrl_wheel[0].kd);
+    uart_sendStr(str);
+    snprintf(str,sizeof(str),"\r\nHeading kp %.2lf ki %.2lf kd %.3lf",ctrl_heading.kp,ctrl_heading.ki,ctrl_heading.kd);
+    uart_sendStr(str);
 }
 /**
- * Primary object detection scan, using ping and ir, display data on uart
+ * Plan a path from the cybot to a cell and list its waypoints
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x goal cell column
+ * @param y goal cell row
+ */
+void draw_plan(int x, int y){
+    int n = plan_find((int)xPos, (int)yPos, x, y);
+    switch(n){
+        case PLAN_FAR :
+            uart_sendStr("\r\nGoal is too far to plan in one window");
+            return;
+        case PLAN_BLOCKED :
+            uart_sendStr("\r\nGoal is an obstacle or too close to one");
+            return;
+        case PLAN_NONE :
+            sprintf(str,"\r\nNo path to (%d,%d), %d nodes in %d us",x,y,(int)plan_expanded,(int)plan_time);
+            uart_sendStr(str);
+            return;
+        case PLAN_FULL :
+            sprintf(str,"\r\nPlan gave up after %d nodes, open set full",(int)plan_expanded);
+            uart_sendStr(str);
+            return;
+    }
+    snprintf(str,sizeof(str),"\r\nPath to (%d,%d) length %d.%d, %d nodes in %d us, open set peak %d",x,y,(int)plan_cost/10,(int)plan_cost%10,(int)plan_expanded,(int)plan_time,(int)plan_peak);
+    uart_sendStr(str);
+    for(n = 0; n < plan_points; n++){
+        sprintf(str,"\r\n  (%d,%d)",plan_path[n].x,plan_path[n].y);
+        uart_sendStr(str);
+    }
+}
+/**
+ * Primary object detection scan, using ping and ir, starts the sweep
  * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
  * @date 12/2/2018
  */
 void scan1(){
-    int *s = malloc(64*sizeof(int));
-    int n = 0, objX,objY,ang=0,dist=0,m=0,tg=0,nw = 0,mw=0;
-    for(ang = 0; ang <= 180; ang += 5){
-        for(dist = 0; dist < 50; dist += 5){
-            if(map[(int)(xPos + dist*cos((heading-90+ang)*rad)/10)][(int)(yPos + dist*sin((heading-90+ang)*rad)/10)] == '#' | map[(int)(xPos + dist*cos((heading-90+ang)*rad)/10)][(int)(yPos + dist*sin((heading-90+ang)*rad)/10)] == 'B')
-                map[(int)(xPos + dist*cos((heading-90+ang)*rad)/10)][(int)(yPos + dist*sin((heading-90+ang)*rad)/10)] = ' ';
-        }
+    sweep_start(&scan);
+    scanning = 1;
+}
+/**
+ * Add the ir readings of a sweep to the occupancy grid, cells a reading passes through are misses and the cell it ends in a hit
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param rec finished sweep taken at the current position
+ */
+void map_scan(const sweep_t *rec){
+    int ang=0,range,hit,x,y;
+    for(ang = 0; ang < SWEEP_POINTS; ang += RAY_STEP){
+        range = rec->ir[ang];
+        hit = range < IR_RANGE;
+        if(!hit)
+            range = IR_RANGE;//free as far as the ir can see
+        scan_cell(range,ang,&x,&y);
+        map_castRay((int)xPos,(int)yPos,x,y,OCC_IR,hit);
     }
-    scan180(s);//for obj[n] use *(s+4*n)
-
+}
+/**
+ * Grid cell of a point seen by the sweep, fixed point so no floating point trig
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param dist distance from the cybot in cm
+ * @param ang sweep angle in degrees, 90 is straight ahead
+ * @param x set to the cell column
+ * @param y set to the cell row
+ */
+void scan_cell(int dist, int ang, int *x, int *y){
+    int32_t a = FIX_DEG((int)heading-90+ang);
+    *x = ((int)(xPos*10) + ((dist*fix_cos(a)) >> 15))/10;//pose in cm, cells are dm
+    *y = ((int)(yPos*10) + ((dist*fix_sin(a)) >> 15))/10;
+}
+/**
+ * Scan task, advance a sweep started by scan1 and process it once it is complete
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void task_scan(){
+    if(!scanning || !sweep_poll())
+        return;
+    scanning = 0;
+    servo_moveTo(90);
+    if(scan.stalled){//the unmeasured points read as open space, so nothing of this scan is mapped
+        sprintf(str,"\r\nScan stopped at %d degrees, the ir sensor is not sampling",scan.points);
+        uart_sendStr(str);
+        return;
+    }
+    scan_objects(&scan, objects);
+    scan_landmarks(objects);//correct the pose before the scan is mapped from it
+    map_scan(&scan);
+    if(binary)
+        tele_objects(objects);
+    else {
+        sprintf(str,"\r\nScan took %d ms",(int)(scan.time/1000));
+        uart_sendStr(str);
+    }
+    scan1_finish(objects);
+    frontier_update((int)xPos, (int)yPos);//only the tiles the scan changed are rechecked
+    if(!binary && frontier_best()){
+        sprintf(str,"\r\nExplore next: (%d,%d) %d cells away",frontier_best()->x,frontier_best()->y,frontier_best()->dist);
+        uart_sendStr(str);
+    }
+    if(scanOutput && scanLine < 0)
+        scanLine = 0;//task_output sends the record
+}
+/**
+ * Feed the objects of a scan that are as wide as a post to the pose filter and move the pose to its estimate
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param s objects found by scan_objects, for obj[n] use *(s+4*n)
+ */
+void scan_landmarks(const int *s){
+    int n, w, used = 0;
+    float oldX = xPos, oldY = yPos, turned;
+    odo_pose_t pose;
     for(n = 0; n < 16 && s[4*n]; n++){
-        nw = (s[4*n+3]*(s[4*n+2]-s[4*n+1]))*rad;
+        w = (s[4*n+3]*(s[4*n+2]-s[4*n+1])*FIX_RAD_Q16) >> 16;
+        if(w <= 3 || w >= 8)
+            continue;//not a post
+        //ping measures to the near face, the middle is about half a width further
+        if(ekf_observe((s[4*n+3] + w/2.0f)/10, (s[4*n+1] + s[4*n+2])/2.0f - 90) >= 0)
+            used++;
+    }
+    if(!used)
+        return;
+    ekf_get(&pose);
+    turned = pose.heading - heading;
+    if(turned > 180)
+        turned -= 360;
+    if(turned < -180)
+        turned += 360;
+    odo_set(pose.x, pose.y, pose.heading);
+    xPos = pose.x;
+    yPos = pose.y;
+    heading = pose.heading;
+    if(!binary){
+        sprintf(str,"\r\nPose corrected by (%.2lf,%.2lf) %.1lf deg from %d posts, %d landmarks",xPos-oldX,yPos-oldY,turned,used,ekf_landmarks);
+        uart_sendStr(str);
+    }
+}
+/**
+ * Report and map the objects found by the primary scan, display data on uart
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param s objects found by scan_objects, for obj[n] use *(s+4*n)
+ */
+void scan1_finish(int *s){
+    int n = 0, objX,objY,m=0,tg=0,nw = 0,mw=0,rn,rm,len;
+
+    for(n = 0; n < 16 && s[4*n] && !binary; n++){//the TELE_OBJECTS frame carries the widths
+        nw = (s[4*n+3]*(s[4*n+2]-s[4*n+1])*FIX_RAD_Q16) >> 16;
         sprintf(str,"\r\nObject %d width: %d",n,nw);
         uart_sendStr(str);
     }
     for(n=0;s[4*n] && n<16;n++){
-        nw = (s[4*n+3]*(s[4*n+2]-s[4*n+1]))*rad;
-        objX = xPos + *(s+4*n+3)*cos((heading-90+*(s+4*n+1))*rad)/10;
-        objY = yPos + *(s+4*n+3)*sin((heading-90+*(s+4*n+1))*rad)/10;
-        if(objX >= 0 && objX <= 2*hype && objY >= 0 && objY <= 2*hype)
-            map[objX][objY] = 'B';
-        objX = xPos + *(s+4*n+3)*cos((heading-90+*(s+4*n+2))*rad)/10;//repeat with angle 2, will probably overlap unless large angular width
-        objY = yPos + *(s+4*n+3)*sin((heading-90+*(s+4*n+2))*rad)/10;
-        if(objX >= 0 && objX <= 2*hype && objY >= 0 && objY <= 2*hype)
-            map[objX][objY] = 'B';
+        nw = (s[4*n+3]*(s[4*n+2]-s[4*n+1])*FIX_RAD_Q16) >> 16;
+        scan_cell(*(s+4*n+3),*(s+4*n+1),&objX,&objY);
+        map_castRay((int)xPos,(int)yPos,objX,objY,OCC_PING,1);
+        scan_cell(*(s+4*n+3),*(s+4*n+2),&objX,&objY);//repeat with angle 2, will probably overlap unless large angular width
+        map_castRay((int)xPos,(int)yPos,objX,objY,OCC_PING,1);
         for(m=n+1;s[4*m] && m<16; m++){
-            mw = (s[4*m+3]*(s[4*m+2]-s[4*m+1]))*rad;
-            tg = ((int)sqrt((s[4*n+3]+1)*(s[4*n+3]+1)+(s[4*m+3]+1)*(s[4*m+3]+1)-2*(s[4*n+3]+1)*(s[4*n+3]+1)*cos(rad*(((s[4*m+1]+s[4*m+2])/2)-((s[4*n+1]+s[4*n+2])/2)))));
+            mw = (s[4*m+3]*(s[4*m+2]-s[4*m+1])*FIX_RAD_Q16) >> 16;
+            //law of cosines between the middles of the two objects
+            rn = s[4*n+3]+1;
+            rm = s[4*m+3]+1;
+            tg = rn*rn + rm*rm - (int)(((int64_t)rn*rm*fix_cos(FIX_DEG(((s[4*m+1]+s[4*m+2])/2)-((s[4*n+1]+s[4*n+2])/2)))) >> 14);
+            tg = tg > 0 ? fix_isqrt(tg) : 0;
             //sprintf(str,"\r\nFor objects %d & %d: %d, %d, %d, %d",n,m,(int)sqrt((*(s+4*n+3))*(*(s+4*n+3))+(*(s+4*m+3))*(*(s+4*m+3))-2*(*(s+4*n+3))*(*(s+4*m+3))*cos(rad*((*(s+4*m+1))-(*(s+4*n+1))))),(int)sqrt((*(s+4*n+3))*(*(s+4*n+3))+(*(s+4*m+3))*(*(s+4*m+3))-2*(*(s+4*n+3))*(*(s+4*m+3))*cos(rad*((*(s+4*m+2))-(*(s+4*n+1))))),(int)sqrt((*(s+4*n+3))*(*(s+4*n+3))+(*(s+4*m+3))*(*(s+4*m+3))-2*(*(s+4*n+3))*(*(s+4*m+3))*cos(rad*((*(s+4*m+1))-(*(s+4*n+2))))),(int)sqrt((*(s+4*n+3))*(*(s+4*n+3))+(*(s+4*m+3))*(*(s+4*m+3))-2*(*(s+4*n+3))*(*(s+4*m+3))*cos(rad*((*(s+4*m+2))-(*(s+4*n+2))))));
-            sprintf(str,"\r\nDistance between objects %d--%d: %d",n,m,tg);
+            if(binary)
+                continue;//the host works out distances from the object list
+            len = sprintf(str,"\r\nDistance between objects %d--%d: %d",n,m,tg);
             if(tg > 53 && tg < 68 && nw > 3 && nw < 8 && mw > 3 && mw < 8 )
-                sprintf(str,"%s likely to be posts");
+                len += sprintf(str+len," likely to be posts");
             uart_sendStr(str);
         }
     }
-
-    free(s);
-    //
 }
 /**
  * Secondary scan using only ir, display data visually iva uart
@@ -278,9 +768,9 @@ void scan1(){
  * @date 12/2/2018
  */
 void scan2(){
-    double ang = 0,pang;
-    int ir = 0, x= 0;
-    for(ang = 0; ang <= 180; ang+=0.25){
+    float ang = 0,pang;
+    int ir = 0, x= 0, len;
+    for(ang = 0; ang <= 180; ang+=0.25f){
         servo_setAngle(ang);
         ir = ir_read();
 
@@ -296,10 +786,10 @@ void scan2(){
             ir = ir/4;
             if(ir < 100){
                 pang = ang;
-                sprintf(str,"\r\n%.2lf:",ang);
+                len = sprintf(str,"\r\n%.2lf:",ang);
                 for(x = 0; x < ir; x+=2)
-                    sprintf(str,"%s ",str);
-                sprintf(str,"%s|#",str);
+                    str[len++] = ' ';
+                sprintf(str+len,"|#");
                 uart_sendStr(str);
             }
         }
@@ -310,7 +800,7 @@ void scan2(){
     }
     sprintf(str,"\r\n");
     uart_sendStr(str);
-    servo_setAngle(90);
+    servo_moveTo(90);
 }
 
 /**
@@ -373,74 +863,247 @@ int check_bump(oi_t *sensor_data){//return 2 conditionals as a 2 bit number {L,R
 	return danger;
 }
 /**
- * update position and heading and tell user about recent movement
+ * tell user about movement since the last report, the pose itself is kept current by the sensor task
  * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
  * @date 12/2/2018
  */
 void update_position(){
-    if(angleDelta){
-        heading+=angleDelta*1.3;
-        sprintf(str,"\r\nturned %d deg ccw",(int)(angleDelta*1.3));
+    if((int)odo_turned){
+        sprintf(str,"\r\nturned %d deg ccw",(int)odo_turned);
         uart_sendStr(str);
-        angleDelta = 0;
-        while(heading >= 360)
-            heading -= 360;
-        while(heading < 0)
-            heading += 360;
-    }
-    if(distanceDelta){
-        sprintf(str,"\r\nmoved %d cm forward",(int)(distanceDelta/10));
+    }
+    if((int)(odo_moved/10)){
+        sprintf(str,"\r\nmoved %d cm forward",(int)(odo_moved/10));
         uart_sendStr(str);
-        distanceDelta = distanceDelta/100;//convert mm to dm
-        xPos += distanceDelta*cos(rad*heading);
-        yPos += distanceDelta*sin(rad*heading);
-        distanceDelta = 0;
     }
-    //need some sin and cosine shit
+    odo_clearMotion();
 }
 /**
- * Draw GUI map
+ * Place the cybot on the map
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x cell column
+ * @param y cell row
+ * @param h heading, ccw from +x in degrees
+ */
+void pose_set(float x, float y, float h){
+    odo_set(x, y, h);
+    ekf_init(x, y, h);
+    xPos = x;
+    yPos = y;
+    heading = h;
+}
+/**
+ * Time the pose update, scan ray and servo command math as they are now against the double precision code they replaced, reported over uart
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void draw_mathBench(){
+    volatile double dx = xPos, dy = yPos, dh = heading, dpos = servo_getAngle(), dd = 0;
+    volatile int sink = 0;//keeps the timed code from being optimized out
+    uint32_t start, before, after;
+    int n, x, y;
+    float a = servo_getAngle();
+    odo_pose_t pose;
+
+    bench_init();
+
+    //update_position, the double code replaced by odo_update, timed on a copy of the pose so the real one and the
+    //frame count control reads are left alone
+    odo_get(&pose);
+    start = bench_cycles();
+    for(n = 0; n < 100; n++){
+        dh += dd*1.3;
+        while(dh >= 360)
+            dh -= 360;
+        while(dh < 0)
+            dh += 360;
+        dx += dd*cos(0.017453292519943*dh);
+        dy += dd*sin(0.017453292519943*dh);
+    }
+    before = (bench_cycles() - start)/100;
+    start = bench_cycles();
+    for(n = 0; n < 100; n++)
+        odo_move(&pose, dd, dd);
+    sink += (int)pose.x;
+    after = (bench_cycles() - start)/100;
+    sprintf(str,"\r\nupdate_position\tdouble %d\tnow %d cycles",(int)before,(int)after);
+    uart_sendStr(str);
+
+    //scan1, cell of one ray end point
+    start = bench_cycles();
+    for(n = 0; n < 100; n++){
+        sink += (int)(dx + 50*cos((dh-90+n)*0.017453292519943)/10);
+        sink += (int)(dy + 50*sin((dh-90+n)*0.017453292519943)/10);
+    }
+    before = (bench_cycles() - start)/100;
+    start = bench_cycles();
+    for(n = 0; n < 100; n++){
+        scan_cell(50, n, &x, &y);
+        sink += x + y;
+    }
+    after = (bench_cycles() - start)/100;
+    sprintf(str,"\r\nscan1 ray\tdouble %d\tnow %d cycles",(int)before,(int)after);
+    uart_sendStr(str);
+
+    //servo_setAngle, pulse width and travel time without the wait, a move to where the servo already is
+    start = bench_cycles();
+    for(n = 0; n < 100; n++){
+        sink += (int)(dpos*10.122+549);
+        sink += abs((int)(dpos*1000-dpos*1000))*5;
+    }
+    before = (bench_cycles() - start)/100;
+    start = bench_cycles();
+    for(n = 0; n < 100; n++)
+        servo_moveTo(a);
+    after = (bench_cycles() - start)/100;
+    sprintf(str,"\r\nservo_setAngle\tdouble %d\tnow %d cycles",(int)before,(int)after);
+    uart_sendStr(str);
+}
+/**
+ * Draw GUI map, waits until the whole map has been queued
  * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
  * @date 12/2/2018
  */
 void draw_map(){
-    uart_sendChar('\r');
-    uart_sendChar('\n');
-    int x = 0,y=0;
-    for(x = 0; x < 2*hype+2; x++){
-        uart_sendChar('-');
-    }
-    uart_sendChar('\r');
-    uart_sendChar('\n');
-    for(y= 2*hype-1;y>=0;y--){
-        uart_sendChar('|');
-        for(x = 0; x < 2*hype; x++){
-            if(x == (int)xPos && y == (int)yPos)
-                uart_sendChar('R');
-            else
-                uart_sendChar(map[x][y]);
+    char line[MAP_LINE_SIZE+1];
+    int n;
+    draw_mapWindow();
+    for(n = 0; n < MAP_LINES; n++){
+        line[draw_mapLine(n, line)] = '\0';
+        uart_sendStr(line);
+    }
+}
+/**
+ * Center the map window on the cybot, the world is much larger than a terminal
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void draw_mapWindow(){
+    mapX = (int)xPos - hype;
+    mapY = (int)yPos - hype;
+}
+/**
+ * Render one line of the GUI map window, line 0 is the top border and line MAP_LINES-1 the bottom border
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param n line to render
+ * @param line buffer of at least MAP_LINE_SIZE characters, not null terminated
+ * @return number of characters rendered
+ */
+int draw_mapLine(int n, char *line){
+    int x = 0,y = mapY+2*hype-n,len = 0;
+    if(n == 0){
+        line[len++] = '\r';
+        line[len++] = '\n';
+    }
+    if(n == 0 || n == MAP_LINES-1){
+        for(x = 0; x < 2*hype+2; x++)
+            line[len++] = '-';
+    } else {
+        line[len++] = '|';
+        len += grid_renderRow(mapX, y, GRID_WIDTH, line + len);
+        if(y == (int)yPos && (int)xPos >= mapX && (int)xPos < mapX + GRID_WIDTH)
+            line[len - GRID_WIDTH + (int)xPos - mapX] = 'R';
+        line[len++] = '|';
+    }
+    line[len++] = '\r';
+    line[len++] = '\n';
+    return len;
+}
+/**
+ * Output task, sends the map, map updates and then the scan record in the background a line at a time whenever the uart has room for a full line
+ * Map updates are a grid_encodeRow message for each changed tile row followed by "$P<x>,<y>,<heading>\r\n" with the cybot cell and heading
+ * In binary mode the scan record goes out as TELE_SWEEP frames instead of text lines
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void task_output(){
+    char line[MAP_LINE_SIZE];//longest line of any of them
+    int len;
+    while(mapLine >= 0 && uart_txFree() >= MAP_LINE_SIZE){
+        uart_sendAsync(line, draw_mapLine(mapLine, line));
+        if(++mapLine == MAP_LINES)
+            mapLine = -1;//done
+    }
+    while(deltaTile >= 0 && mapLine < 0 && uart_txFree() >= GRID_RLE_SIZE){
+        deltaTile = grid_nextDirty(deltaTile);
+        if(deltaTile < 0){
+            len = sprintf(line,"$P%d,%d,%d\r\n",(int)xPos,(int)yPos,(int)heading);
+            uart_sendAsync(line, len);
+            break;//done
         }
-        uart_sendChar('|');
-        uart_sendChar('\r');
-        uart_sendChar('\n');
+        uart_sendAsync(line, grid_encodeRow(deltaTile, line));//the tile stays dirty until each of its rows is sent
     }
-    for(x = 0; x < 2*hype+2; x++){
-        uart_sendChar('-');
+    while(binary && scanLine >= 0 && mapLine < 0 && deltaTile < 0 && uart_txFree() >= TELE_SWEEP_SIZE){
+        tele_sweep(&scan, scanLine);
+        scanLine += TELE_SWEEP_CHUNK;
+        if(scanLine >= SWEEP_POINTS)
+            scanLine = -1;//done
+    }
+    while(!binary && scanLine >= 0 && mapLine < 0 && deltaTile < 0 && uart_txFree() >= SCAN_LINE_SIZE){
+        len = 0;
+        if(scanLine == 0)
+            len = sprintf(line,"\r\nAngle\tIR\tSONAR\r\n");
+        len += sweep_formatLine(&scan, scanLine, line + len);
+        uart_sendAsync(line, len);
+        if(++scanLine == SWEEP_POINTS)
+            scanLine = -1;//done
     }
-    uart_sendChar('\r');
-    uart_sendChar('\n');
 }
 /**
- * set up map and fill with unexplored region
+ * set up map, the whole world starts unexplored
  * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
  * @date 12/2/2018
  */
 void map_init(){
-    int x= 0,y=0;
-    for(y= 0;y<2*hype;y++){
-        for(x = 0; x < 2*hype; x++){
-            map[x][y] = '#';
-        }
+    grid_clear();
+}
+/**
+ * Save the map, pose and calibration to the EEPROM, takes a few tens of ms
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void checkpoint_save(){
+    calibration_t cal;
+    pose_t pose;
+    int tiles;
+    cal.irCali = ir_cali;
+    cal.zeroOffset = zero_offset;
+    cal.servoDelta = delta;
+    cal.edgeThresh = edgeThresh;
+    pose.x = xPos;
+    pose.y = yPos;
+    pose.heading = heading;
+    tiles = map_save();
+    if(!store_write(STORE_CAL, &cal, sizeof(cal)) || !store_write(STORE_POSE, &pose, sizeof(pose)) || tiles < 0)
+        sprintf(str,"\r\nCheckpoint failed, %d EEPROM errors",(int)store_errors);
+    else
+        sprintf(str,"\r\nCheckpoint saved %d/%d map tiles",tiles,grid_tilesUsed());
+    uart_sendStr(str);
+}
+/**
+ * Load calibration, pose and map saved by checkpoint_save, anything missing keeps its default
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void checkpoint_load(){
+    calibration_t cal;
+    pose_t pose;
+    int tiles;
+    if(store_read(STORE_CAL, &cal, sizeof(cal)) && cal.irCali > 0 && cal.servoDelta > 0){
+        ir_cali = cal.irCali;
+        zero_offset = cal.zeroOffset;
+        delta = cal.servoDelta;
+        edgeThresh = cal.edgeThresh;
+        sprintf(str,"\r\nCalibration loaded, CALI %d servo %d + %d.%03d us/deg",(int)ir_cali,zero_offset,(int)delta,(int)(delta*1000)%1000);
+        uart_sendStr(str);
+    }
+    if(store_read(STORE_POSE, &pose, sizeof(pose)) && grid_inBounds((int)pose.x, (int)pose.y) && pose.heading >= 0 && pose.heading < 360){
+        tiles = map_load();
+        pose_set(pose.x, pose.y, pose.heading);
+        sprintf(str,"\r\nResumed at (%d,%d) heading %d with %d map tiles",(int)xPos,(int)yPos,(int)heading,tiles);
+        uart_sendStr(str);
     }
 }
 /**
@@ -449,7 +1112,9 @@ void map_init(){
  * @date 12/2/2018
  */
 void draw_heading(){
-    sprintf(str,"\r\nHeading is %.0lf degrees ccw of +x direction\r\nPosition is (%.2lf,%.2lf) relative to bottom left\r\n",heading,xPos,yPos);
+    snprintf(str,sizeof(str),"\r\nHeading is %.0lf degrees ccw of +x direction",heading);
+    uart_sendStr(str);
+    snprintf(str,sizeof(str),"\r\nPosition is (%.2lf,%.2lf) relative to bottom left of the world\r\n",xPos,yPos);
     uart_sendStr(str);
 }
 /**
@@ -0,0 +1,130 @@
+/**
+ * @file scheduler.c
+ * @brief cooperative fixed-period task scheduler used by the main project loop
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+#include "scheduler.h"
+#include <stdbool.h>
+#include "Timer.h"
+
+task_t tasks[SCHED_MAX_TASKS];
+int numTasks = 0;
+volatile int sched_running = 0;
+
+/**
+ * Start the microsecond clock and clear the task table
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void sched_init(void){
+    numTasks = 0;
+    timer_init();
+}
+/**
+ * Add a task to the end of the table, tasks that are released together run in table order
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param name short name used when reporting task statistics
+ * @param run function called once per release
+ * @param period time between releases in ms
+ * @param deadline time after release by which run must have returned in ms
+ * @return task index or -1 if the table is full
+ */
+int sched_addTask(const char *name, void (*run)(void), uint32_t period, uint32_t deadline){
+    task_t *t;
+    if(numTasks >= SCHED_MAX_TASKS)
+        return -1;
+    t = &tasks[numTasks];
+    t->name = name;
+    t->run = run;
+    t->period = period;
+    t->deadline = deadline;
+    t->release = timer_now();//first release is immediate
+    t->runs = 0;
+    t->overruns = 0;
+    t->worst = 0;
+    return numTasks++;
+}
+/**
+ * Dispatch released tasks until sched_stop is called
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void sched_run(void){
+    int i;
+    uint32_t start, end, period;
+    task_t *t;
+    sched_running = 1;
+    while(sched_running){
+        for(i = 0; i < numTasks && sched_running; i++){
+            t = &tasks[i];
+            if(!timer_expired(t->release))
+                continue;//not released yet
+
+            start = timer_now();
+            t->run();
+            end = timer_now();
+
+            t->runs++;
+            if(end - start > t->worst)
+                t->worst = end - start;
+            if((int32_t)(end - (t->release + t->deadline*1000)) > 0)
+                t->overruns++;//finished after its deadline
+
+            period = t->period*1000;
+            t->release += period;
+            if((int32_t)(end - t->release) >= 0){//fell a whole period or more behind, skip the lost releases
+                t->overruns += (end - t->release)/period + 1;
+                t->release = end + period;
+            }
+        }
+    }
+}
+/**
+ * Make sched_run return once the current task finishes
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void sched_stop(void){
+    sched_running = 0;
+}
+/**
+ * Milliseconds since the microsecond clock started
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return scheduler time in ms
+ */
+uint32_t sched_millis(void){
+    return (uint32_t)(timer_now64()/1000);
+}
+/**
+ * Microseconds since the microsecond clock started, same as timer_now
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return scheduler time in us
+ */
+uint32_t sched_micros(void){
+    return timer_now();
+}
+/**
+ * Number of tasks in the table
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return number of tasks added with sched_addTask
+ */
+int sched_numTasks(void){
+    return numTasks;
+}
+/**
+ * Get a task so its statistics can be reported
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param id task index returned by sched_addTask
+ * @return pointer to the task or 0 if id is out of range
+ */
+const task_t *sched_getTask(int id){
+    if(id < 0 || id >= numTasks)
+        return 0;
+    return &tasks[id];
+}
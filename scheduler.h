@@ -0,0 +1,86 @@
+/**
+ * @file scheduler.h
+ * @brief cooperative fixed-period task scheduler used by the main project loop
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <stdint.h>
+
+#define SCHED_MAX_TASKS 8
+
+/// Fixed-period task, run to completion by sched_run
+typedef struct {
+    const char *name;
+    void (*run)(void);
+    uint32_t period;   //ms between releases
+    uint32_t deadline; //ms after release the task must have finished by
+    uint32_t release;  //timer_now time of next release in us
+    uint32_t runs;     //number of times the task has been run
+    uint32_t overruns; //releases that finished late or were skipped
+    uint32_t worst;    //longest execution time seen in us
+} task_t;
+
+/**
+ * Start the microsecond clock and clear the task table
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void sched_init(void);
+/**
+ * Add a task to the end of the table, tasks that are released together run in table order
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param name short name used when reporting task statistics
+ * @param run function called once per release
+ * @param period time between releases in ms
+ * @param deadline time after release by which run must have returned in ms
+ * @return task index or -1 if the table is full
+ */
+int sched_addTask(const char *name, void (*run)(void), uint32_t period, uint32_t deadline);
+/**
+ * Dispatch released tasks until sched_stop is called
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void sched_run(void);
+/**
+ * Make sched_run return once the current task finishes
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void sched_stop(void);
+/**
+ * Milliseconds since the microsecond clock started
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return scheduler time in ms
+ */
+uint32_t sched_millis(void);
+/**
+ * Microseconds since the microsecond clock started, same as timer_now
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return scheduler time in us
+ */
+uint32_t sched_micros(void);
+/**
+ * Number of tasks in the table
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return number of tasks added with sched_addTask
+ */
+int sched_numTasks(void);
+/**
+ * Get a task so its statistics can be reported
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param id task index returned by sched_addTask
+ * @return pointer to the task or 0 if id is out of range
+ */
+const task_t *sched_getTask(int id);
+
+#endif /* SCHEDULER_H_ */
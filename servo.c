@@ -18,12 +18,17 @@
 
 //delta and offset must be calibrated with measurement and a linear regression
 //currently calibrated for cybot 8
-double position = 0;
-double ppos; //previous position
+float position = 0;
+float ppos; //previous position
 unsigned pulse_period = 0x4E200; //320000 aka 20 ms
 int zero_offset = 549;//(8)441; //pulse width in us at 0 deg
-double delta = 10.122;//(8)9.4722; //us high per degree change
+float delta = 10.122f;//(8)9.4722; //us high per degree change
 //t_high = angle*delta + zero_offset
+unsigned slew_rate = 5; //us of travel per millidegree, the wait the old busy-wait servo_setAngle used, not measured
+
+float target = 0; //angle of the last move
+uint32_t move_start = 0; //timer_now when the last move was commanded
+uint32_t move_time = 0; //us the last move takes to settle, from the slew rate model
 /**
  * Sets PWM wave pulse width
  * @author Jordan Fox, Scott Beard
@@ -63,15 +68,59 @@ void servo_init(){
 //*/
 }
 /**
- * Sets servo angle
+ * Sets servo angle and waits for it to get there
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ */
+void servo_setAngle(float a){
+    servo_moveTo(a);
+    while(!servo_isSettled());
+}
+/**
+ * Start moving the servo to an angle and return immediately
  * @author Jordan Fox, Scott Beard
  * @date 12/2/2018
+ * @param a angle to move to in degrees
  */
-void servo_setAngle(double a){
+void servo_moveTo(float a){
+    ppos = servo_getAngle();//a move in progress starts from wherever it has got to
     servo_setPulse((int)(a*delta+zero_offset));
-    int change = abs((int)(a*1000-ppos*1000));
-    timer_waitMicros(change*5);
-    ppos = a;
+    move_time = abs((int)(a*1000-ppos*1000))*slew_rate;
+    move_start = timer_now();
+    target = a;
+}
+/**
+ * Check if the servo has finished the last move
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ * @return 1 if the servo is at its target, 0 if still moving
+ */
+int servo_isSettled(){
+    return timer_elapsed(move_start) >= move_time;
+}
+/**
+ * Time left until the servo finishes the last move
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ * @return time until settled in us, 0 if already settled
+ */
+uint32_t servo_settleTime(){
+    uint32_t elapsed = timer_elapsed(move_start);
+    if(elapsed >= move_time)
+        return 0;
+    return move_time - elapsed;
+}
+/**
+ * Estimated servo angle, moves are modeled as a constant slew rate
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ * @return angle in degrees
+ */
+float servo_getAngle(){
+    uint32_t elapsed = timer_elapsed(move_start);
+    if(elapsed >= move_time)
+        return target;
+    return ppos + (target-ppos)*elapsed/move_time;
 }
 /**
  * Demonstrative function from servo lab
@@ -108,7 +157,7 @@ void servo_test(){
             position += dir*1;
             break;
         case 2:
-            position += dir*2.5;
+            position += dir*2.5f;
             break;
         case 3:
             position += dir*5;
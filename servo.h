@@ -14,6 +14,11 @@
 #include <stdbool.h>
 #include "driverlib/interrupt.h"
 #include "tm4c123gh6pm.h"
+
+//pulse width in us is angle*delta + zero_offset, per cybot
+extern int zero_offset;
+extern float delta;
+
 /**
  * Sets PWM wave pulse width
  * @author Jordan Fox, Scott Beard
@@ -28,11 +33,39 @@ void servo_setPulse(int micro);
  */
 void servo_init();
 /**
- * Sets servo angle
+ * Sets servo angle and waits for it to get there
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ */
+void servo_setAngle(float a);
+/**
+ * Start moving the servo to an angle and return immediately
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ * @param a angle to move to in degrees
+ */
+void servo_moveTo(float a);
+/**
+ * Check if the servo has finished the last move
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ * @return 1 if the servo is at its target, 0 if still moving
+ */
+int servo_isSettled();
+/**
+ * Time left until the servo finishes the last move
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ * @return time until settled in us, 0 if already settled
+ */
+uint32_t servo_settleTime();
+/**
+ * Estimated servo angle, moves are modeled as a constant slew rate
  * @author Jordan Fox, Scott Beard
  * @date 12/2/2018
+ * @return angle in degrees
  */
-void servo_setAngle(double a);
+float servo_getAngle();
 /**
  * Demonstrative function from servo lab
  * @author Jordan Fox, Scott Beard
@@ -0,0 +1,314 @@
+/**
+ * @file store.c
+ * @brief versioned record store in the 2 KB on-chip EEPROM, keeps the map, pose and calibration across resets
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+#include "store.h"
+#include "telemetry.h"
+#ifndef STORE_RAM
+#include "tm4c123gh6pm.h"
+#endif
+
+//slot header, word 0 is magic, version and payload length and is written last so it commits the record
+//word 1 is a sequence number to find the newest slot and the crc of word 0 and the payload, same crc as the telemetry frames
+const store_region_t store_regions[STORE_REGIONS] = {
+    {0, 8, 4},    //STORE_CAL, 24 byte records
+    {32, 8, 4},   //STORE_POSE, 24 byte records
+    {64, 224, 2}, //STORE_MAP, 888 byte records, two so a reset during a checkpoint keeps the last one
+};
+uint32_t store_errors = 0;
+#ifdef STORE_RAM
+uint32_t store_ram[STORE_WORDS];
+#endif
+
+//record being written
+int store_wrRegion = -1; //-1 if none
+int store_wrSlot;
+uint16_t store_wrSeq;
+int store_wrLen; //payload bytes so far
+int store_wrFailed;
+uint32_t store_wrWord; //payload bytes not yet written, low byte first
+uint16_t store_wrCrc; //crc of the payload so far
+//record being read
+int store_rdWord; //next payload word
+int store_rdLeft; //payload bytes left
+uint32_t store_rdPart; //bytes of the current word not yet returned
+int store_rdPartLen;
+
+/**
+ * Read one word of EEPROM
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param w word address
+ * @return word
+ */
+uint32_t store_readWord(int w){
+#ifdef STORE_RAM
+    return store_ram[w];
+#else
+    EEPROM_EEBLOCK_R = w >> 4;
+    EEPROM_EEOFFSET_R = w & 15;
+    return EEPROM_EERDWR_R;
+#endif
+}
+/**
+ * Write one word of EEPROM, waits for it to program
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param w word address
+ * @param v word
+ * @return 1 if written
+ */
+int store_writeWord(int w, uint32_t v){
+#ifdef STORE_RAM
+    store_ram[w] = v;
+    return 1;
+#else
+    EEPROM_EEBLOCK_R = w >> 4;
+    EEPROM_EEOFFSET_R = w & 15;
+    if(EEPROM_EERDWR_R == v)
+        return 1;//already there, don't wear it
+    EEPROM_EERDWR_R = v;
+    while(EEPROM_EEDONE_R & EEPROM_EEDONE_WORKING);
+    if(EEPROM_EEDONE_R & (EEPROM_EEDONE_NOPERM | EEPROM_EEDONE_INVPL)){
+        store_errors++;
+        return 0;
+    }
+    return 1;
+#endif
+}
+/**
+ * Start the EEPROM, call before any other store function
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return 1 if the EEPROM is usable, 0 if it needs a retry the store cannot do
+ */
+int store_init(void){
+#ifdef STORE_RAM
+    return 1;
+#else
+    SYSCTL_RCGCEEPROM_R |= SYSCTL_RCGCEEPROM_R0;
+    while(!(SYSCTL_PREEPROM_R & SYSCTL_PREEPROM_R0));
+    while(EEPROM_EEDONE_R & EEPROM_EEDONE_WORKING);//finishes a copy or erase a reset interrupted
+    if(EEPROM_EESUPP_R & (EEPROM_EESUPP_PRETRY | EEPROM_EESUPP_ERETRY))
+        return 0;
+    return 1;
+#endif
+}
+/**
+ * Largest record a region holds
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param region STORE_CAL, STORE_POSE or STORE_MAP
+ * @return payload bytes
+ */
+int store_capacity(int region){
+    return (store_regions[region].slotWords - 2) * 4;
+}
+/**
+ * Check a slot and read its header
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param region region
+ * @param slot slot in the region
+ * @param seq set to the sequence number of the record
+ * @return payload bytes, -1 if the slot does not hold a valid record of this version
+ */
+int store_check(int region, int slot, uint16_t *seq){
+    int base = store_regions[region].first + slot*store_regions[region].slotWords;
+    uint32_t h0 = store_readWord(base), h1, w;
+    int len = h0 & 0xFFFF, n;
+    uint16_t crc;
+    uint8_t b[4];
+    if((h0 >> 24) != STORE_MAGIC || ((h0 >> 16) & 0xFF) != STORE_VERSION || len > store_capacity(region))
+        return -1;
+    h1 = store_readWord(base + 1);
+    crc = 0xFFFF;
+    for(n = 0; n < len; n += 4){
+        w = store_readWord(base + 2 + n/4);
+        b[0] = w; b[1] = w >> 8; b[2] = w >> 16; b[3] = w >> 24;
+        crc = tele_crc(crc, b, len - n < 4 ? len - n : 4);
+    }
+    b[0] = h0; b[1] = h0 >> 8; b[2] = h0 >> 16; b[3] = h0 >> 24;
+    crc = tele_crc(crc, b, 4);
+    if(crc != (h1 & 0xFFFF))
+        return -1;
+    *seq = h1 >> 16;
+    return len;
+}
+/**
+ * Find the newest valid record in a region
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param region region
+ * @param seq set to its sequence number
+ * @return slot, -1 if none
+ */
+int store_newest(int region, uint16_t *seq){
+    int slot, best = -1;
+    uint16_t s;
+    for(slot = 0; slot < store_regions[region].slots; slot++){
+        if(store_check(region, slot, &s) < 0)
+            continue;
+        if(best < 0 || (int16_t)(s - *seq) > 0){//sequence numbers wrap
+            best = slot;
+            *seq = s;
+        }
+    }
+    return best;
+}
+/**
+ * Start writing a record, the previous record in the region stays readable until store_end commits this one
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param region STORE_CAL, STORE_POSE or STORE_MAP
+ */
+void store_begin(int region){
+    uint16_t seq = 0;
+    int slot = store_newest(region, &seq);
+    store_wrRegion = region;
+    store_wrSlot = slot < 0 ? 0 : (slot + 1) % store_regions[region].slots;
+    store_wrSeq = seq + 1;
+    store_wrLen = 0;
+    store_wrWord = 0;
+    store_wrFailed = 0;
+    store_wrCrc = 0xFFFF;
+    //clear the old header first so a reset part way through can't pair it with a half written payload
+    if(!store_writeWord(store_regions[region].first + store_wrSlot*store_regions[region].slotWords, 0))
+        store_wrFailed = 1;
+}
+/**
+ * Bytes left in the record being written
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return bytes that can still be added
+ */
+int store_room(void){
+    if(store_wrRegion < 0 || store_wrFailed)
+        return 0;
+    return store_capacity(store_wrRegion) - store_wrLen;
+}
+/**
+ * Add bytes to the record being written
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param data bytes to add
+ * @param len number of bytes
+ * @return 1 if added, 0 if they do not fit and the record will not be committed
+ */
+int store_put(const void *data, int len){
+    const uint8_t *p = (const uint8_t *)data;
+    const store_region_t *r;
+    if(len > store_room()){
+        store_wrFailed = 1;
+        return 0;
+    }
+    r = &store_regions[store_wrRegion];
+    store_wrCrc = tele_crc(store_wrCrc, p, len);
+    while(len--){
+        store_wrWord |= (uint32_t)*p++ << ((store_wrLen & 3) << 3);
+        if((++store_wrLen & 3) == 0){
+            if(!store_writeWord(r->first + store_wrSlot*r->slotWords + 1 + store_wrLen/4, store_wrWord))
+                store_wrFailed = 1;
+            store_wrWord = 0;
+        }
+    }
+    return 1;
+}
+/**
+ * Commit the record being written by writing its header last, a reset before this leaves the previous record
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return 1 if committed, 0 if it overflowed or a write failed
+ */
+int store_end(void){
+    const store_region_t *r;
+    int base;
+    uint32_t h0;
+    uint8_t b[4];
+    uint16_t crc;
+    if(store_wrRegion < 0)
+        return 0;
+    r = &store_regions[store_wrRegion];
+    base = r->first + store_wrSlot*r->slotWords;
+    store_wrRegion = -1;
+    if(store_wrLen & 3)//partial last word
+        if(!store_writeWord(base + 2 + store_wrLen/4, store_wrWord))
+            store_wrFailed = 1;
+    if(store_wrFailed)
+        return 0;
+    h0 = ((uint32_t)STORE_MAGIC << 24) | ((uint32_t)STORE_VERSION << 16) | store_wrLen;
+    b[0] = h0; b[1] = h0 >> 8; b[2] = h0 >> 16; b[3] = h0 >> 24;
+    crc = tele_crc(store_wrCrc, b, 4);//header after the payload, as store_check reads it
+    return store_writeWord(base + 1, ((uint32_t)store_wrSeq << 16) | crc) && store_writeWord(base, h0);
+}
+/**
+ * Write a whole record
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param region STORE_CAL, STORE_POSE or STORE_MAP
+ * @param data payload
+ * @param len payload bytes
+ * @return 1 if committed
+ */
+int store_write(int region, const void *data, int len){
+    store_begin(region);
+    store_put(data, len);
+    return store_end();
+}
+/**
+ * Find the newest record in a region whose version and crc check out and start reading it
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param region STORE_CAL, STORE_POSE or STORE_MAP
+ * @return payload bytes, -1 if the region has no valid record
+ */
+int store_open(int region){
+    uint16_t seq = 0;
+    int slot = store_newest(region, &seq);
+    store_rdLeft = 0;
+    store_rdPartLen = 0;
+    if(slot < 0)
+        return -1;
+    store_rdWord = store_regions[region].first + slot*store_regions[region].slotWords + 2;
+    store_rdLeft = store_check(region, slot, &seq);
+    return store_rdLeft;
+}
+/**
+ * Read the next bytes of the record opened by store_open
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param data filled with the bytes
+ * @param len number of bytes
+ * @return number of bytes read, less than len at the end of the record
+ */
+int store_get(void *data, int len){
+    uint8_t *p = (uint8_t *)data;
+    int n = 0;
+    while(n < len && store_rdLeft > 0){
+        if(!store_rdPartLen){
+            store_rdPart = store_readWord(store_rdWord++);
+            store_rdPartLen = 4;
+        }
+        p[n++] = store_rdPart;
+        store_rdPart >>= 8;
+        store_rdPartLen--;
+        store_rdLeft--;
+    }
+    return n;
+}
+/**
+ * Read a whole record
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param region STORE_CAL, STORE_POSE or STORE_MAP
+ * @param data filled with the payload
+ * @param len payload bytes expected
+ * @return 1 if a valid record of exactly len bytes was read
+ */
+int store_read(int region, void *data, int len){
+    if(store_open(region) != len)
+        return 0;
+    return store_get(data, len) == len;
+}
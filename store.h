@@ -0,0 +1,117 @@
+/**
+ * @file store.h
+ * @brief versioned record store in the 2 KB on-chip EEPROM, keeps the map, pose and calibration across resets
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+
+#ifndef STORE_H_
+#define STORE_H_
+
+#include <stdint.h>
+
+//build with STORE_RAM defined to keep records in a RAM array instead, for testing the layout off the cybot
+#define STORE_WORDS 512 //32 bit words of EEPROM, 32 blocks of 16
+#define STORE_MAGIC 0xCB
+#define STORE_VERSION 1 //bump when a record layout changes so old records are ignored instead of misread
+
+//regions, each is a ring of slots and a write goes to the slot after the newest record to spread the wear
+#define STORE_CAL 0  //calibration constants
+#define STORE_POSE 1 //cybot position and heading
+#define STORE_MAP 2  //map checkpoint from map_save
+#define STORE_REGIONS 3
+
+/// Where a region lives in the EEPROM, each slot starts with two header words
+typedef struct {
+    uint16_t first;     //first word
+    uint16_t slotWords; //words per slot including the header
+    uint8_t slots;      //slots in the ring
+} store_region_t;
+
+extern const store_region_t store_regions[STORE_REGIONS];
+extern uint32_t store_errors; //EEPROM writes that failed
+
+/**
+ * Start the EEPROM, call before any other store function
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return 1 if the EEPROM is usable, 0 if it needs a retry the store cannot do
+ */
+int store_init(void);
+/**
+ * Largest record a region holds
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param region STORE_CAL, STORE_POSE or STORE_MAP
+ * @return payload bytes
+ */
+int store_capacity(int region);
+/**
+ * Start writing a record, the previous record in the region stays readable until store_end commits this one
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param region STORE_CAL, STORE_POSE or STORE_MAP
+ */
+void store_begin(int region);
+/**
+ * Bytes left in the record being written
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return bytes that can still be added
+ */
+int store_room(void);
+/**
+ * Add bytes to the record being written
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param data bytes to add
+ * @param len number of bytes
+ * @return 1 if added, 0 if they do not fit and the record will not be committed
+ */
+int store_put(const void *data, int len);
+/**
+ * Commit the record being written by writing its header last, a reset before this leaves the previous record
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return 1 if committed, 0 if it overflowed or a write failed
+ */
+int store_end(void);
+/**
+ * Write a whole record
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param region STORE_CAL, STORE_POSE or STORE_MAP
+ * @param data payload
+ * @param len payload bytes
+ * @return 1 if committed
+ */
+int store_write(int region, const void *data, int len);
+/**
+ * Find the newest record in a region whose version and crc check out and start reading it
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param region STORE_CAL, STORE_POSE or STORE_MAP
+ * @return payload bytes, -1 if the region has no valid record
+ */
+int store_open(int region);
+/**
+ * Read the next bytes of the record opened by store_open
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param data filled with the bytes
+ * @param len number of bytes
+ * @return number of bytes read, less than len at the end of the record
+ */
+int store_get(void *data, int len);
+/**
+ * Read a whole record
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param region STORE_CAL, STORE_POSE or STORE_MAP
+ * @param data filled with the payload
+ * @param len payload bytes expected
+ * @return 1 if a valid record of exactly len bytes was read
+ */
+int store_read(int region, void *data, int len);
+
+#endif /* STORE_H_ */
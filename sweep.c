@@ -0,0 +1,165 @@
+/**
+ * @file sweep.c
+ * @brief 180 degree ir and ping sweep that overlaps servo travel, ping flight and ir sampling
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+#include "sweep.h"
+#include <stdio.h>
+#include "Timer.h"
+#include "servo.h"
+#include "ir.h"
+#include "ping.h"
+
+#define SWEEP_IR_WINDOW 3 //ir samples taken after the servo settles that are averaged for each point
+#define SWEEP_PING_TIMEOUT 20000 //us, the PING))) echo pulse is at most 18.5 ms
+#define SWEEP_IR_TIMEOUT 20000 //us after the servo settles, a point then uses the samples it has, none ends the sweep
+
+#define SWEEP_IDLE 0
+#define SWEEP_MOVING 1 //waiting for the servo to settle on the current angle
+#define SWEEP_SAMPLING 2 //waiting for ir samples taken after it settled
+#define SWEEP_LANDING 3 //all points measured, waiting for the last ping to come back
+
+sweep_t *sweep_rec;
+int sweep_state = SWEEP_IDLE;
+int sweep_angle; //angle of the point being measured
+uint32_t sweep_begin; //timer_now when the sweep started
+uint32_t sweep_settled; //timer_now when the servo settled on sweep_angle
+int sweep_pingAngle = -1; //point the ping in flight belongs to, -1 if none
+uint32_t sweep_pingSent; //timer_now when that ping was sent
+
+/**
+ * Start a sweep from 0 to 180 degrees, the servo starts moving immediately
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param rec scan record to fill, must stay valid until the sweep is done
+ */
+void sweep_start(sweep_t *rec){
+    int n;
+    for(n = 0; n < SWEEP_POINTS; n++){
+        rec->ir[n] = 255;
+        rec->ping[n] = 0;
+    }
+    rec->points = 0;
+    rec->stalled = 0;
+    rec->time = 0;
+    sweep_rec = rec;
+    sweep_angle = 0;
+    sweep_pingAngle = -1;
+    sweep_begin = timer_now();
+    servo_moveTo(0);
+    sweep_state = SWEEP_MOVING;
+}
+/**
+ * Fire the next ping as soon as the last one has come back, pings run freely alongside the servo
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void sweep_ping(){
+    int dist;
+    if(sweep_pingAngle >= 0){
+        dist = ping_check();
+        if(!dist && timer_elapsed(sweep_pingSent) < SWEEP_PING_TIMEOUT)
+            return;//still in flight
+        if(dist)
+            sweep_rec->ping[sweep_pingAngle] = dist > 255 ? 255 : dist;
+        sweep_pingAngle = -1;
+    }
+    if(sweep_state == SWEEP_SAMPLING || (sweep_state == SWEEP_MOVING && sweep_angle > 0)){//not while the servo swings to the start
+        sweep_pingAngle = sweep_angle;
+        ping_ready();
+        ping_sendPulse();
+        sweep_pingSent = timer_now();
+    }
+}
+/**
+ * Finish the record, points between pings take the distance of the last ping before them
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void sweep_finish(){
+    int n;
+    uint8_t last = 255;
+    for(n = 0; n < SWEEP_POINTS; n++){
+        if(sweep_rec->ping[n])
+            last = sweep_rec->ping[n];
+        else
+            sweep_rec->ping[n] = last;
+    }
+    sweep_rec->time = timer_elapsed(sweep_begin);
+    sweep_state = SWEEP_IDLE;
+}
+/**
+ * Advance the sweep, never waits, call as often as possible
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return 1 once the record is complete or if no sweep was started, 0 while sweeping
+ */
+int sweep_poll(void){
+    int dist, n;
+    if(sweep_state == SWEEP_IDLE)
+        return 1;
+
+    sweep_ping();
+
+    if(sweep_state == SWEEP_LANDING){
+        if(sweep_pingAngle >= 0)
+            return 0;
+        sweep_finish();
+        return 1;
+    }
+    if(sweep_state == SWEEP_MOVING){
+        if(!servo_isSettled())
+            return 0;
+        sweep_settled = timer_now();
+        sweep_state = SWEEP_SAMPLING;
+    }
+    n = ir_samplesSince(sweep_settled);
+    if(n < SWEEP_IR_WINDOW){
+        if(timer_elapsed(sweep_settled) < SWEEP_IR_TIMEOUT)
+            return 0;
+        if(!n){//the adc stopped, end the sweep rather than wait for it forever
+            sweep_rec->stalled = 1;
+            sweep_state = SWEEP_LANDING;
+            return 0;
+        }
+    }else
+        n = SWEEP_IR_WINDOW;
+
+    dist = ir_readAverage(n);
+    sweep_rec->ir[sweep_angle] = dist > 255 ? 255 : dist;
+    sweep_rec->points++;
+
+    if(sweep_angle == SWEEP_POINTS - 1){
+        sweep_state = SWEEP_LANDING;
+        return 0;
+    }
+    servo_moveTo(++sweep_angle);
+    sweep_state = SWEEP_MOVING;
+    return 0;
+}
+/**
+ * Check if a sweep is in progress
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return 1 while sweeping
+ */
+int sweep_busy(void){
+    return sweep_state != SWEEP_IDLE;
+}
+/**
+ * Render one point of a scan record as "angle\tIR\tSONAR\r\n"
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param rec scan record
+ * @param n point to render, 0 to SWEEP_POINTS-1
+ * @param line buffer of at least SWEEP_LINE_SIZE characters, not null terminated
+ * @return number of characters rendered
+ */
+int sweep_formatLine(const sweep_t *rec, int n, char *line){
+    char buf[SWEEP_LINE_SIZE+1];
+    int len = sprintf(buf, "%d\t%d\t%d\r\n", n, rec->ir[n], rec->ping[n]);
+    for(n = 0; n < len; n++)
+        line[n] = buf[n];
+    return len;
+}
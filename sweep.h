@@ -0,0 +1,57 @@
+/**
+ * @file sweep.h
+ * @brief 180 degree ir and ping sweep that overlaps servo travel, ping flight and ir sampling
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+
+#ifndef SWEEP_H_
+#define SWEEP_H_
+
+#include <stdint.h>
+
+#define SWEEP_POINTS 181 //one point per degree from 0 to 180
+#define SWEEP_LINE_SIZE 16 //longest line from sweep_formatLine
+
+/// Result of one sweep, ir and ping distance at every degree
+typedef struct {
+    uint8_t ir[SWEEP_POINTS];   //ir distance in cm, 255 if further
+    uint8_t ping[SWEEP_POINTS]; //ping distance in cm, 255 if further, held from the last ping sent at a lower angle
+    uint16_t points;            //points filled so far
+    uint8_t stalled;            //1 if the ir stopped sampling and the sweep ended early at points
+    uint32_t time;              //us the sweep took
+} sweep_t;
+
+/**
+ * Start a sweep from 0 to 180 degrees, the servo starts moving immediately
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param rec scan record to fill, must stay valid until the sweep is done
+ */
+void sweep_start(sweep_t *rec);
+/**
+ * Advance the sweep, never waits, call as often as possible
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return 1 once the record is complete or if no sweep was started, 0 while sweeping
+ */
+int sweep_poll(void);
+/**
+ * Check if a sweep is in progress
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return 1 while sweeping
+ */
+int sweep_busy(void);
+/**
+ * Render one point of a scan record as "angle\tIR\tSONAR\r\n"
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param rec scan record
+ * @param n point to render, 0 to SWEEP_POINTS-1
+ * @param line buffer of at least SWEEP_LINE_SIZE characters, not null terminated
+ * @return number of characters rendered
+ */
+int sweep_formatLine(const sweep_t *rec, int n, char *line);
+
+#endif /* SWEEP_H_ */
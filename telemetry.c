@@ -0,0 +1,208 @@
+/**
+ * @file telemetry.c
+ * @brief framed binary messages on the uart, a compact alternative to the text reports for a host program
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+#include "telemetry.h"
+#include "uart.h"
+#include "fixmath.h"
+
+uint32_t tele_dropped = 0;
+int tele_open = 0; //1 while a frame started by tele_begin is being written
+uint16_t tele_frameCrc; //crc of the frame being written
+//crc of every 4-bit value, two lookups per byte keep the table at 32 bytes
+const uint16_t tele_crcTable[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+/**
+ * Update a CRC-16/CCITT with more bytes
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param crc crc so far, 0xFFFF to start
+ * @param data bytes to add
+ * @param len number of bytes
+ * @return updated crc
+ */
+uint16_t tele_crc(uint16_t crc, const uint8_t *data, int len){
+    while(len--){
+        crc ^= (uint16_t)*data++ << 8;
+        crc = (crc << 4) ^ tele_crcTable[crc >> 12];
+        crc = (crc << 4) ^ tele_crcTable[crc >> 12];
+    }
+    return crc;
+}
+/**
+ * Store a 16 bit field little endian
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param p where to store it
+ * @param v value
+ */
+static inline void tele_put16(uint8_t *p, int v){
+    p[0] = v;
+    p[1] = v >> 8;
+}
+/**
+ * Start a frame, the whole frame is queued only if the uart has room for all of it so frames are never cut short
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param type message type
+ * @param len payload length, the tele_write calls that follow must add up to it
+ * @return 1 if the frame was started, 0 if it was dropped
+ */
+int tele_begin(uint8_t type, int len){
+    uint8_t head[3];
+    if(len > TELE_MAX_PAYLOAD || uart_txFree() < len + TELE_OVERHEAD){
+        tele_dropped++;
+        tele_open = 0;
+        return 0;
+    }
+    head[0] = TELE_SYNC;
+    head[1] = type;
+    head[2] = len;
+    tele_frameCrc = tele_crc(0xFFFF, head + 1, 2);
+    uart_sendAsync((const char *)head, 3);
+    tele_open = 1;
+    return 1;
+}
+/**
+ * Add payload bytes to the frame being sent, does nothing if tele_begin dropped it
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param data payload bytes
+ * @param len number of bytes
+ */
+void tele_write(const void *data, int len){
+    if(!tele_open)
+        return;
+    tele_frameCrc = tele_crc(tele_frameCrc, (const uint8_t *)data, len);
+    uart_sendAsync((const char *)data, len);//tele_begin made room for the whole frame
+}
+/**
+ * Finish the frame being sent with its crc
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void tele_end(void){
+    uint8_t tail[2];
+    if(!tele_open)
+        return;
+    tele_put16(tail, tele_frameCrc);
+    uart_sendAsync((const char *)tail, 2);
+    tele_open = 0;
+}
+/**
+ * Send a whole frame
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param type message type
+ * @param payload payload bytes
+ * @param len payload length
+ * @return 1 if queued, 0 if dropped
+ */
+int tele_send(uint8_t type, const void *payload, int len){
+    if(!tele_begin(type, len))
+        return 0;
+    tele_write(payload, len);
+    tele_end();
+    return 1;
+}
+/**
+ * Send the cybot position
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x position in dm
+ * @param y position in dm
+ * @param heading degrees ccw of +x
+ * @param time ms since startup
+ * @return 1 if queued, 0 if dropped
+ */
+int tele_pose(float x, float y, float heading, uint32_t time){
+    uint8_t p[10];
+    tele_put16(p, (int)(x*10));
+    tele_put16(p + 2, (int)(y*10));
+    tele_put16(p + 4, (int)(heading*10));
+    tele_put16(p + 6, time);
+    tele_put16(p + 8, time >> 16);
+    return tele_send(TELE_POSE, p, sizeof(p));
+}
+/**
+ * Send a hazard event
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param kind TELE_HAZARD_PING, TELE_HAZARD_CLIFF, TELE_HAZARD_EDGE or TELE_HAZARD_BUMP
+ * @param sides sensors that triggered, {L,FL,FR,R} as bits 3 to 0
+ * @param x position in dm
+ * @param y position in dm
+ * @return 1 if queued, 0 if dropped
+ */
+int tele_hazard(int kind, int sides, float x, float y){
+    uint8_t p[6];
+    p[0] = kind;
+    p[1] = sides;
+    tele_put16(p + 2, (int)(x*10));
+    tele_put16(p + 4, (int)(y*10));
+    return tele_send(TELE_HAZARD, p, sizeof(p));
+}
+/**
+ * Send up to TELE_SWEEP_CHUNK points of a sweep, straight from the record without copying
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param rec finished sweep
+ * @param first first point to send
+ * @return 1 if queued, 0 if dropped
+ */
+int tele_sweep(const sweep_t *rec, int first){
+    uint8_t head[2];
+    int count = SWEEP_POINTS - first;
+    if(count > TELE_SWEEP_CHUNK)
+        count = TELE_SWEEP_CHUNK;
+    if(count <= 0)
+        return 0;
+    if(!tele_begin(TELE_SWEEP, 2 + 2*count))
+        return 0;
+    head[0] = first;
+    head[1] = count;
+    tele_write(head, 2);
+    tele_write(&rec->ir[first], count);
+    tele_write(&rec->ping[first], count);
+    tele_end();
+    return 1;
+}
+/**
+ * Send the objects found by scan_objects
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param obj objects filled by scan_objects, for obj[n] use *(obj+4*n)
+ * @return 1 if queued, 0 if dropped
+ */
+int tele_objects(const int *obj){
+    uint8_t p[1 + 4*TELE_OBJECTS_MAX];
+    int n, width;
+    for(n = 0; n < TELE_OBJECTS_MAX && obj[4*n]; n++){
+        width = (obj[4*n+3]*(obj[4*n+2]-obj[4*n+1])*FIX_RAD_Q16) >> 16;
+        p[1+4*n] = obj[4*n+1];
+        p[2+4*n] = obj[4*n+2];
+        p[3+4*n] = obj[4*n+3];
+        p[4+4*n] = width > 255 ? 255 : width;
+    }
+    p[0] = n;
+    return tele_send(TELE_OBJECTS, p, 1 + 4*n);
+}
+/**
+ * Send the battery level
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param charge mAh left
+ * @param capacity mAh when full
+ * @return 1 if queued, 0 if dropped
+ */
+int tele_battery(int charge, int capacity){
+    uint8_t p[4];
+    tele_put16(p, charge);
+    tele_put16(p + 2, capacity);
+    return tele_send(TELE_BATTERY, p, sizeof(p));
+}
@@ -0,0 +1,132 @@
+/**
+ * @file telemetry.h
+ * @brief framed binary messages on the uart, a compact alternative to the text reports for a host program
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdint.h>
+#include "sweep.h"
+
+//frame is sync, type, payload length, payload, crc16 low byte then high byte
+//the crc is CRC-16/CCITT (polynomial 0x1021, initial 0xFFFF) over type, length and payload
+//text is always 7-bit so a reader can skip it while searching for the sync byte
+#define TELE_SYNC 0xA5
+#define TELE_OVERHEAD 5 //bytes in a frame besides the payload
+#define TELE_MAX_PAYLOAD 255
+
+//message types, multi-byte fields are little endian
+#define TELE_POSE 1    //int16 x cm, int16 y cm, int16 heading in tenths of a degree ccw of +x, uint32 time ms
+#define TELE_HAZARD 2  //uint8 kind, uint8 sides {L,FL,FR,R} as bits 3 to 0, int16 x cm, int16 y cm
+#define TELE_SWEEP 3   //uint8 first angle, uint8 count, count ir distances, count ping distances, in cm
+#define TELE_OBJECTS 4 //uint8 count, then per object uint8 first angle, last angle, distance cm, width cm
+#define TELE_BATTERY 5 //uint16 charge mAh, uint16 capacity mAh
+
+//hazard kinds
+#define TELE_HAZARD_PING 0 //object imminent
+#define TELE_HAZARD_CLIFF 1
+#define TELE_HAZARD_EDGE 2
+#define TELE_HAZARD_BUMP 3
+
+#define TELE_SWEEP_CHUNK 61 //points per TELE_SWEEP frame, a whole sweep is three frames
+#define TELE_SWEEP_SIZE (TELE_OVERHEAD + 2 + 2*TELE_SWEEP_CHUNK) //longest TELE_SWEEP frame
+#define TELE_OBJECTS_MAX 16
+
+extern uint32_t tele_dropped; //frames not sent because the uart transmit queue was full
+
+/**
+ * Update a CRC-16/CCITT with more bytes
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param crc crc so far, 0xFFFF to start
+ * @param data bytes to add
+ * @param len number of bytes
+ * @return updated crc
+ */
+uint16_t tele_crc(uint16_t crc, const uint8_t *data, int len);
+/**
+ * Start a frame, the whole frame is queued only if the uart has room for all of it so frames are never cut short
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param type message type
+ * @param len payload length, the tele_write calls that follow must add up to it
+ * @return 1 if the frame was started, 0 if it was dropped
+ */
+int tele_begin(uint8_t type, int len);
+/**
+ * Add payload bytes to the frame being sent, does nothing if tele_begin dropped it
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param data payload bytes
+ * @param len number of bytes
+ */
+void tele_write(const void *data, int len);
+/**
+ * Finish the frame being sent with its crc
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void tele_end(void);
+/**
+ * Send a whole frame
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param type message type
+ * @param payload payload bytes
+ * @param len payload length
+ * @return 1 if queued, 0 if dropped
+ */
+int tele_send(uint8_t type, const void *payload, int len);
+/**
+ * Send the cybot position
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x position in dm
+ * @param y position in dm
+ * @param heading degrees ccw of +x
+ * @param time ms since startup
+ * @return 1 if queued, 0 if dropped
+ */
+int tele_pose(float x, float y, float heading, uint32_t time);
+/**
+ * Send a hazard event
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param kind TELE_HAZARD_PING, TELE_HAZARD_CLIFF, TELE_HAZARD_EDGE or TELE_HAZARD_BUMP
+ * @param sides sensors that triggered, {L,FL,FR,R} as bits 3 to 0
+ * @param x position in dm
+ * @param y position in dm
+ * @return 1 if queued, 0 if dropped
+ */
+int tele_hazard(int kind, int sides, float x, float y);
+/**
+ * Send up to TELE_SWEEP_CHUNK points of a sweep, straight from the record without copying
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param rec finished sweep
+ * @param first first point to send
+ * @return 1 if queued, 0 if dropped
+ */
+int tele_sweep(const sweep_t *rec, int first);
+/**
+ * Send the objects found by scan_objects
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param obj objects filled by scan_objects, for obj[n] use *(obj+4*n)
+ * @return 1 if queued, 0 if dropped
+ */
+int tele_objects(const int *obj);
+/**
+ * Send the battery level
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param charge mAh left
+ * @param capacity mAh when full
+ * @return 1 if queued, 0 if dropped
+ */
+int tele_battery(int charge, int capacity);
+
+#endif /* TELEMETRY_H_ */
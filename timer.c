@@ -5,37 +5,103 @@
  */
 
 #include "Timer.h"
+#include <stdbool.h>
+#include "driverlib/interrupt.h"
 
 volatile uint32_t _timer_ticks;
 
+//upper 32 bits of the microsecond clock, counted by the wide timer 0 timeout interrupt
+volatile uint32_t _timer_wraps = 0;
+static uint8_t _timer_running = 0;
+
+///Wide timer 0 A timeout, the microsecond clock wrapped
+void WTIMER0A_Handler(void) {
+	WTIMER0_ICR_R = TIMER_ICR_TATOCINT;
+	_timer_wraps++;
+}
+
+void timer_init(void) {
+	if(_timer_running)
+		return;
+	_timer_running = 1;
+
+	//Enable wide timer 0 and wait until it is ready
+	SYSCTL_RCGCWTIMER_R |= SYSCTL_RCGCWTIMER_R0;
+	while(!(SYSCTL_PRWTIMER_R & SYSCTL_PRWTIMER_R0));
+
+	//Disable timer A while we set it up
+	WTIMER0_CTL_R &= ~TIMER_CTL_TAEN;
+
+	//Split the 64-bit timer, timer A is 32 bits plus a 16-bit prescaler
+	WTIMER0_CFG_R = TIMER_CFG_16_BIT;
+
+	//Periodic, count down through the whole 32 bits
+	WTIMER0_TAMR_R = TIMER_TAMR_TAMR_PERIOD;
+	WTIMER0_TAILR_R = 0xFFFFFFFF;
+
+	//Set the prescaler to 15 (period = 1us)
+	WTIMER0_TAPR_R = 15;
+
+	//Interrupt on timeout to count wraps, IRQ 94
+	WTIMER0_ICR_R = TIMER_ICR_TATOCINT;
+	WTIMER0_IMR_R = TIMER_IMR_TATOIM;
+	NVIC_EN2_R |= 0x40000000;
+	IntRegister(INT_WTIMER0A, WTIMER0A_Handler);
+	IntMasterEnable();
+
+	//Start the clock, it is never stopped
+	WTIMER0_CTL_R |= TIMER_CTL_TAEN;
+}
+
+uint32_t timer_now(void) {
+	if(!_timer_running)
+		timer_init(); //lets modules that wait during their own init run before anything else
+	//timer counts down, so invert it to count up
+	return ~WTIMER0_TAR_R;
+}
+
+uint64_t timer_now64(void) {
+	uint32_t wraps;
+	uint32_t now;
+
+	do {
+		wraps = _timer_wraps;
+		now = timer_now();
+	} while(wraps != _timer_wraps || (now < 0x1000 && (WTIMER0_RIS_R & TIMER_RIS_TATORIS)));
+	//second test catches a wrap whose interrupt has not run yet, e.g. when called with interrupts off
+
+	return ((uint64_t) wraps << 32) | now;
+}
+
+uint32_t timer_deadline(uint32_t micros) {
+	return timer_now() + micros;
+}
+
+int timer_expired(uint32_t deadline) {
+	//signed difference stays correct across the 32-bit wrap for deadlines up to 35 minutes away
+	return (int32_t) (timer_now() - deadline) >= 0;
+}
+
+uint32_t timer_elapsed(uint32_t since) {
+	return timer_now() - since;
+}
+
 void timer_waitMillis(uint32_t millis) {
-	///Start timer with period of 1ms
-	timer_startTimer(999);
+	uint32_t deadline = timer_now();
 
 	///loop until enough milliseconds have passed
 	while(millis > 0) {
-		///wait until the millisecond timer has timed out
-		while(!(TIMER5_RIS_R & TIMER_RIS_TATORIS));
-
-		///Reset the timeout flag
-		TIMER5_ICR_R |= TIMER_RIS_TATORIS;
+		deadline += 1000;
+		while(!timer_expired(deadline));
 
 		millis--;
 	}
-
-	///Stop the timer
-	timer_stopTimer();
 }
 
 void timer_waitMicros(uint16_t micros) {
-	//Start timer with period of 1us
-	timer_startTimer(micros - 1);
-
-	while(!(TIMER5_RIS_R & TIMER_RIS_TATORIS));
-
-	TIMER5_ICR_R |= TIMER_RIS_TATORIS;
+	uint32_t deadline = timer_deadline(micros);
 
-	timer_stopTimer();
+	while(!timer_expired(deadline));
 }
 
 void timer_startTimer(uint16_t startValue) {
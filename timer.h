@@ -26,8 +26,28 @@ typedef uint32_t clock_t;
 
 extern volatile uint32_t _timer_ticks;
 
+///Start the free running microsecond clock on wide timer 0, called automatically by timer_now
+void timer_init(void);
+
+///Microseconds since the clock started, wraps every 71 minutes
+uint32_t timer_now(void);
+
+///Microseconds since the clock started, never wraps
+uint64_t timer_now64(void);
+
+///Deadline the given number of microseconds from now, for timer_expired
+uint32_t timer_deadline(uint32_t micros);
+
+///1 once the deadline has passed, 0 before, deadlines must be less than 35 minutes away
+int timer_expired(uint32_t deadline);
+
+///Microseconds since a timer_now reading
+uint32_t timer_elapsed(uint32_t since);
+
+///Blocking wait, other modules can keep timing while it runs
 void timer_waitMillis(uint32_t millis);
 
+///Blocking wait, other modules can keep timing while it runs
 void timer_waitMicros(uint16_t micros);
 
 void timer_startTimer(uint16_t startValue);
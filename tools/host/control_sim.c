@@ -0,0 +1,183 @@
+/**
+ * @file control_sim.c
+ * @brief host simulation of the closed loop wheel and heading control, each wheel follows its command through a first
+ * order lag with a dead band, the left one 7% slow, and odometry only sees whole encoder counts, run once with the tasks
+ * in step with the sensor frames and once with their period jittered
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "control.h"
+#include "odometry.h"
+#include "host.h"
+
+#define FRAME_US 15000 //a sensor frame every 15 ms
+#define LAG 0.08 //s, wheel time constant
+#define LEFT_GAIN 0.93 //left wheel runs slow
+#define DEAD_BAND 4 //mm/s, commands below this don't move a wheel
+#define START 1024 //start cell on both axes
+#define JITTER 7 //ms, task period wander for the second run of the checks
+
+int commandLeft = 0, commandRight = 0;
+double speedLeft = 0, speedRight = 0; //mm/s
+double pathLeft = 0, pathRight = 0; //mm each wheel really travelled
+int jitter = 0; //ms the task period wanders either way, 0 runs it in step with the frames
+int steadySpread; //mm/s the left wheel command spans on a straight run in step with the frames
+
+/**
+ * What the cybot gets from the open interface, recorded for the wheel model
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param right_wheel mm/s
+ * @param left_wheel mm/s
+ */
+void oi_setWheels(int16_t right_wheel, int16_t left_wheel){
+    commandRight = right_wheel;
+    commandLeft = left_wheel;
+}
+/**
+ * Run the wheels for one task period in 1 ms steps, the Create samples the counts every 15 ms, then the sensor and
+ * control tasks run like task_sensors and task_control, with jitter the period wanders so a run can get no frame or two
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void frame(void){
+    static uint16_t countLeft, countRight;
+    double targetLeft, targetRight;
+    int n, frames = 0, period = FRAME_US/1000;
+    if(jitter)
+        period += rand() % (2*jitter + 1) - jitter;
+    for(n = 0; n < period; n++){
+        targetLeft = abs(commandLeft) < DEAD_BAND ? 0 : commandLeft*LEFT_GAIN;
+        targetRight = abs(commandRight) < DEAD_BAND ? 0 : commandRight;
+        speedLeft += (targetLeft - speedLeft)*0.001/LAG;
+        speedRight += (targetRight - speedRight)*0.001/LAG;
+        pathLeft += speedLeft*0.001;
+        pathRight += speedRight*0.001;
+        host_micros += 1000;
+        if(host_micros % FRAME_US == 0){
+            countLeft = (uint16_t)(long)floor(pathLeft/ODO_MM_PER_COUNT);
+            countRight = (uint16_t)(long)floor(pathRight/ODO_MM_PER_COUNT);
+            frames++;
+        }
+    }
+    if(frames)
+        odo_update(countLeft, countRight, frames);
+    ctrl_update();
+}
+/**
+ * Heading the wheels really turned the cybot to
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return degrees ccw from the start, not wrapped
+ */
+double true_heading(void){
+    return (pathRight - pathLeft)/ODO_WHEEL_BASE*(180/M_PI);
+}
+/**
+ * Run frames until the control goes idle, then let the wheels stop
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param limit most frames to wait
+ * @return frames until idle, limit if it never got there
+ */
+int settle(int limit){
+    int n, frames;
+    for(frames = 0; frames < limit && ctrl_mode != CTRL_IDLE; frames++)
+        frame();
+    for(n = 0; n < 40; n++)
+        frame();
+    return frames;
+}
+/**
+ * Straight runs hold the heading even with one wheel slow, and once up to speed the wheel command wanders no more with
+ * a jittered task than it does in step with the frames
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void check_straight(void){
+    double h0 = true_heading(), err;
+    int n, low = 1000, high = -1000;
+    ctrl_drive(100);
+    for(n = 0; n < 400; n++){
+        frame();
+        if(n >= 200 && commandLeft < low)
+            low = commandLeft;
+        if(n >= 200 && commandLeft > high)
+            high = commandLeft;
+    }
+    ctrl_stop();
+    for(n = 0; n < 40; n++)
+        frame();
+    err = true_heading() - h0;
+    printf("straight 6 s: heading off by %.3f deg, left wheel command %d to %d mm/s\n", err, low, high);
+    HOST_CHECK(fabs(err) < 0.1);
+    if(!jitter)
+        steadySpread = high - low;//whole encoder counts make the measured speed step
+    else
+        HOST_CHECK(high - low <= steadySpread + 6);
+}
+/**
+ * Turns by an angle land within tolerance, measured on the real wheel travel
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void check_turns(void){
+    const float angles[] = {90, -45, 180, -170, 10, 3, 1.5f, -1};
+    double h0, err, worst = 0;
+    int n, frames;
+    for(n = 0; n < (int)(sizeof(angles)/sizeof(angles[0])); n++){
+        h0 = true_heading();
+        ctrl_turn(angles[n]);
+        frames = settle(2000);
+        HOST_CHECK(ctrl_mode == CTRL_IDLE);
+        err = true_heading() - h0 - angles[n];
+        printf("turn %6.1f deg: idle after %4d frames, off by %.2f deg\n", angles[n], frames, err);
+        if(fabs(err) > worst)
+            worst = fabs(err);
+    }
+    HOST_CHECK(worst < 0.5);
+}
+/**
+ * Moves by a distance stop within a millimetre on the real wheel travel and hold the heading
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void check_moves(void){
+    const float distances[] = {500, -200, 30, 5, 1000};
+    double m0, h0, err, turned, worst = 0, worstTurn = 0;
+    int n, frames;
+    for(n = 0; n < (int)(sizeof(distances)/sizeof(distances[0])); n++){
+        m0 = (pathLeft + pathRight)/2;
+        h0 = true_heading();
+        ctrl_move(distances[n], 100);
+        frames = settle(3000);
+        HOST_CHECK(ctrl_mode == CTRL_IDLE);
+        err = (pathLeft + pathRight)/2 - m0 - distances[n];
+        turned = true_heading() - h0;
+        printf("move %6.0f mm: idle after %4d frames, off by %.2f mm, heading by %.3f deg\n", distances[n], frames, err,
+               turned);
+        if(fabs(err) > worst)
+            worst = fabs(err);
+        if(fabs(turned) > worstTurn)
+            worstTurn = fabs(turned);
+    }
+    HOST_CHECK(worst < 1);
+    HOST_CHECK(worstTurn < 0.2);
+}
+
+int main(void){
+    odo_set(START, START, 90);
+    frame();
+    check_straight();
+    check_turns();
+    check_moves();
+    printf("task period jittered by up to %d ms, some runs get no frame and some two\n", JITTER);
+    jitter = JITTER;
+    check_straight();
+    check_turns();
+    check_moves();
+    return host_report("control_sim");
+}
@@ -0,0 +1,130 @@
+/**
+ * @file ekf_sim.c
+ * @brief host simulation of the pose filter, laps of a square near four posts with biased odometry, run once on
+ * odometry alone and once with the filter correcting it from noisy post sightings
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "ekf.h"
+#include "odometry.h"
+#include "host.h"
+
+#define START 1024 //start cell on both axes
+#define LAPS 40
+#define SIDE 400 //mm
+#define STEPS 50 //odometry steps in each drive or turn
+#define SIGHT 8 //dm, posts further away aren't seen
+
+const double posts[4][2] = {{START + 7, START + 7}, {START - 3, START + 7}, {START - 3, START - 3}, {START + 7, START - 3}};
+double trueX, trueY, trueHeading; //where the cybot really is, dm and radians
+odo_pose_t pose; //what the cybot thinks
+int filtering;
+
+/**
+ * Normally distributed noise
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return sample with mean 0 and standard deviation 1
+ */
+double gauss(void){
+    double u = (rand() + 1.0)/(RAND_MAX + 2.0), v = (rand() + 1.0)/(RAND_MAX + 2.0);
+    return sqrt(-2*log(u))*cos(2*M_PI*v);
+}
+/**
+ * Drive and turn in small steps, odometry sees each step 3% long, turns 2% over and a slight drift to the left
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param mm distance driven
+ * @param degrees turned ccw
+ */
+void drive(double mm, double degrees){
+    double d, t, mid;
+    float seenD, seenT;
+    int n;
+    for(n = 0; n < STEPS; n++){
+        d = mm/STEPS;
+        t = degrees/STEPS*M_PI/180;
+        mid = trueHeading + t/2;
+        trueX += d/100*cos(mid);
+        trueY += d/100*sin(mid);
+        trueHeading += t;
+        seenD = d*1.03;
+        seenT = (t*1.02 + 0.0004*d/100)*180/M_PI;
+        odo_move(&pose, seenD, seenT);
+        if(filtering)
+            ekf_predict(&pose, seenD, seenT);
+    }
+}
+/**
+ * Sight the posts in front of the cybot with 3 cm of range noise and 2 degrees of bearing noise, and take the filter's
+ * pose as the cybot's own the way pose_set does
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void scan(void){
+    double dx, dy, range, bearing;
+    int k, used = 0;
+    if(!filtering)
+        return;
+    for(k = 0; k < 4; k++){
+        dx = posts[k][0] - trueX;
+        dy = posts[k][1] - trueY;
+        range = sqrt(dx*dx + dy*dy);
+        bearing = remainder(atan2(dy, dx) - trueHeading, 2*M_PI);
+        if(range > SIGHT || fabs(bearing) > M_PI/2)
+            continue;
+        used += ekf_observe(range + gauss()*0.3, (bearing + gauss()*0.035)*180/M_PI) >= 0;
+    }
+    if(used)
+        ekf_get(&pose);
+}
+/**
+ * Run the laps
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param filter 1 to use the filter
+ * @param position filled with the worst position error in dm
+ * @param heading filled with the worst heading error in degrees
+ */
+void laps(int filter, double *position, double *heading){
+    double e;
+    int lap, side;
+    filtering = filter;
+    srand(1);
+    trueX = trueY = START;
+    trueHeading = M_PI/2;
+    odo_set(START, START, 90);
+    odo_get(&pose);
+    ekf_init(START, START, 90);
+    *position = *heading = 0;
+    for(lap = 0; lap < LAPS; lap++){
+        for(side = 0; side < 4; side++){
+            scan();
+            drive(SIDE, 0);
+            scan();
+            drive(0, -90);
+        }
+        e = hypot(pose.x - trueX, pose.y - trueY);
+        if(e > *position)
+            *position = e;
+        e = fabs(remainder(pose.heading*M_PI/180 - trueHeading, 2*M_PI))*180/M_PI;
+        if(e > *heading)
+            *heading = e;
+    }
+}
+
+int main(void){
+    double position, heading;
+    laps(0, &position, &heading);
+    printf("odometry alone: worst %.2f dm and %.1f deg off\n", position, heading);
+    HOST_CHECK(position > 3);
+    laps(1, &position, &heading);
+    printf("with the filter: worst %.2f dm and %.1f deg off, %d landmarks\n", position, heading, ekf_landmarks);
+    HOST_CHECK(position < 0.5);
+    HOST_CHECK(heading < 8);
+    HOST_CHECK(ekf_landmarks == 4);
+    return host_report("ekf_sim");
+}
@@ -0,0 +1,129 @@
+/**
+ * @file fixmath_test.c
+ * @brief host test of the fixed point kernels against the double precision library, every angle for sin and cos,
+ * vectors of every scale for atan2 and isqrt to 2^24 and around every larger square, then each kernel timed against libm
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "fixmath.h"
+#include "host.h"
+
+#define CALLS 10000000 //calls timed for each kernel
+
+/**
+ * fix_sin within 2 LSB of sin at every binary angle, fix_cos is it a quarter turn ahead
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void check_sin(void){
+    double err, worst = 0;
+    int32_t n, bad = 0;
+    for(n = 0; n < FIX_TURN; n++){
+        err = fabs(fix_sin(n) - 32768*sin(n*2*M_PI/FIX_TURN));
+        if(err > worst)
+            worst = err;
+        bad += fix_cos(n) != fix_sin(n + FIX_TURN/4);
+        bad += fix_sin(n) != fix_sin(n + 3*FIX_TURN);//only the low 16 bits count
+    }
+    printf("sin worst error %.2f LSB\n", worst);
+    HOST_CHECK(worst <= 2);
+    HOST_CHECK(bad == 0);
+    HOST_CHECK(fix_sin(FIX_TURN/4) == FIX_ONE && fix_sin(-FIX_TURN/4) == -FIX_ONE && fix_cos(0) == FIX_ONE);
+}
+/**
+ * fix_atan2 within 0.1 degree around the circle at radii from 10 to a million, and 0 for a zero vector
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void check_atan2(void){
+    const double radii[] = {10, 100, 1000, 30000, 1000000};
+    double err, worst = 0, a;
+    int32_t x, y;
+    int n, r;
+    for(r = 0; r < (int)(sizeof(radii)/sizeof(radii[0])); r++)
+        for(n = 0; n < 36000; n++){
+            a = n*M_PI/18000;
+            x = lround(radii[r]*cos(a));
+            y = lround(radii[r]*sin(a));
+            err = fabs(fix_atan2(y, x)*360.0/FIX_TURN - atan2(y, x)*180/M_PI);
+            if(err > 180)
+                err = 360 - err;//+-180 are the same angle
+            if(err > worst)
+                worst = err;
+        }
+    printf("atan2 worst error %.3f deg\n", worst);
+    HOST_CHECK(worst < 0.1);
+    HOST_CHECK(fix_atan2(0, 0) == 0);
+}
+/**
+ * fix_isqrt is the floor of the square root for every value to 2^24, around every square and at the top of the range
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void check_isqrt(void){
+    uint32_t n, r;
+    int bad = 0;
+    for(n = 0; n < 1u << 24; n++){
+        r = fix_isqrt(n);
+        bad += (uint64_t)r*r > n || (uint64_t)(r + 1)*(r + 1) <= n;
+    }
+    for(r = 4096; r < 65536; r++){
+        bad += fix_isqrt(r*r) != r;
+        bad += fix_isqrt(r*r - 1) != r - 1;
+    }
+    bad += fix_isqrt(0xFFFFFFFF) != 65535;
+    HOST_CHECK(bad == 0);
+}
+/**
+ * Time each kernel against its libm call, on the host this only shows the ratio, fix_bench ('k') gives cycles on the
+ * cybot
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void bench(void){
+    volatile int32_t sinkI = 0;
+    volatile double sinkD = 0;
+    uint64_t start, fix, lib;
+    int32_t n;
+
+    start = host_nanos();
+    for(n = 0; n < CALLS; n++)
+        sinkI ^= fix_sin(n*7);
+    fix = host_nanos() - start;
+    start = host_nanos();
+    for(n = 0; n < CALLS; n++)
+        sinkD += sin(n*7*(2*M_PI/FIX_TURN));
+    lib = host_nanos() - start;
+    printf("sin\tfix %.1f ns\tlibm %.1f ns\n", (double)fix/CALLS, (double)lib/CALLS);
+
+    start = host_nanos();
+    for(n = 0; n < CALLS; n++)
+        sinkI ^= fix_atan2((n & 2047) - 1024, 1000 - (n & 1023));
+    fix = host_nanos() - start;
+    start = host_nanos();
+    for(n = 0; n < CALLS; n++)
+        sinkD += atan2((n & 2047) - 1024, 1000 - (n & 1023));
+    lib = host_nanos() - start;
+    printf("atan2\tfix %.1f ns\tlibm %.1f ns\n", (double)fix/CALLS, (double)lib/CALLS);
+
+    start = host_nanos();
+    for(n = 0; n < CALLS; n++)
+        sinkI ^= fix_isqrt(n);
+    fix = host_nanos() - start;
+    start = host_nanos();
+    for(n = 0; n < CALLS; n++)
+        sinkD += sqrt(n);
+    lib = host_nanos() - start;
+    printf("sqrt\tfix %.1f ns\tlibm %.1f ns\n", (double)fix/CALLS, (double)lib/CALLS);
+}
+
+int main(void){
+    check_sin();
+    check_atan2();
+    check_isqrt();
+    bench();
+    return host_report("fixmath_test");
+}
@@ -0,0 +1,120 @@
+/**
+ * @file frontier_test.c
+ * @brief host test of incremental frontier tracking, the cells found and how many tiles each update rechecks
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+#include <stdio.h>
+#include "frontier.h"
+#include "host.h"
+
+#define X0 (GRID_ORIGIN - 4) //square of free cells that straddles tile edges
+#define Y0 (GRID_ORIGIN - 4)
+#define SIDE 20
+#define BIG 112 //7x7 tiles, more than GRID_TILES holds
+
+/**
+ * A free square walled on the right is one frontier around the other three sides, walling the bottom rechecks only
+ * the tiles it touched and an update with nothing new rechecks none
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void check_square(void){
+    const frontier_t *f;
+    int x, y, checked;
+    grid_clear();
+    for(y = Y0; y < Y0 + SIDE; y++)
+        for(x = X0; x < X0 + SIDE; x++)
+            grid_set(x, y, x == X0 + SIDE - 1 ? GRID_OBJECT : GRID_FREE);
+    checked = frontier_update(X0 + SIDE/2, Y0 + SIDE/2);
+    HOST_CHECK(checked == grid_tilesUsed());
+    HOST_CHECK(frontier_count == 1);
+    f = frontier_best();
+    HOST_CHECK(f && f->size == SIDE + 2*(SIDE - 1) - 2);//left column, top and bottom rows, the corners once each
+    HOST_CHECK(f && f->minX == X0 && f->maxX == X0 + SIDE - 2 && f->minY == Y0 && f->maxY == Y0 + SIDE - 1);
+    HOST_CHECK(f && grid_get(f->x, f->y) == GRID_FREE);
+
+    for(x = X0; x < X0 + SIDE - 1; x++)//the row below the square lies in the bottom two tiles
+        grid_set(x, Y0 - 1, GRID_OBJECT);
+    checked = frontier_update(X0 + SIDE/2, Y0 + SIDE/2);
+    printf("after walling the bottom %d tiles rechecked, %d frontiers\n", checked, frontier_count);
+    HOST_CHECK(checked == 2);
+    HOST_CHECK(frontier_count == 1 && frontier_best()->size == SIDE + (SIDE - 1) - 1);
+    HOST_CHECK(frontier_update(X0 + SIDE/2, Y0 + SIDE/2) == 0);
+}
+/**
+ * A walled area bigger than the tile pool, so tiles get evicted while it is mapped, has no unexplored cells and no
+ * frontiers left, the evicted tiles read as free instead of drawing the cybot back
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void check_evicted(void){
+    int x, y, unexplored = 0;
+    uint32_t evicted = grid_evictions;
+    grid_clear();
+    for(y = Y0; y < Y0 + BIG; y++)
+        for(x = X0; x < X0 + BIG; x++)
+            grid_set(x, y, x == X0 || y == Y0 || x == X0 + BIG - 1 || y == Y0 + BIG - 1 ? GRID_OBJECT : GRID_FREE);
+    for(y = Y0 + 1; y < Y0 + BIG - 1; y++)
+        for(x = X0 + 1; x < X0 + BIG - 1; x++)
+            unexplored += grid_get(x, y) == GRID_UNEXPLORED;
+    frontier_update(X0 + BIG/2, Y0 + BIG/2);
+    printf("%dx%d walled area: %u tiles evicted, %d cells unexplored, %d frontiers\n", BIG, BIG,
+           (unsigned)(grid_evictions - evicted), unexplored, frontier_count);
+    HOST_CHECK(grid_evictions != evicted);
+    HOST_CHECK(unexplored == 0);
+    HOST_CHECK(frontier_count == 0);
+    HOST_CHECK(frontier_update(X0 + BIG/2, Y0 + BIG/2) == 0 && frontier_count == 0);
+}
+/**
+ * Half scan one tile, its other half unexplored
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param tx tile column
+ * @param ty tile row
+ * @param rows rows from the bottom to make free
+ */
+void scan_rows(int tx, int ty, int rows){
+    int x, y;
+    for(y = 0; y < rows; y++)
+        for(x = 0; x < GRID_TILE; x++)
+            grid_set((tx << GRID_TILE_SHIFT) + x, (ty << GRID_TILE_SHIFT) + y, GRID_FREE);
+}
+/**
+ * A partly scanned tile outlives fully explored ones, and when only partly scanned tiles are left to evict it comes back
+ * unexplored rather than free, so its frontier is found again
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void check_partial(void){
+    const int tx = GRID_ORIGIN >> GRID_TILE_SHIFT, ty = tx;
+    const int x0 = tx << GRID_TILE_SHIFT, y0 = ty << GRID_TILE_SHIFT;
+    int n;
+    grid_clear();
+    scan_rows(tx, ty, GRID_TILE/2);
+    for(n = 1; n <= GRID_TILES + 4; n++)
+        scan_rows(tx + n, ty + 4, GRID_TILE);
+    HOST_CHECK(grid_get(x0, y0) == GRID_FREE && grid_get(x0, y0 + GRID_TILE - 1) == GRID_UNEXPLORED);
+
+    grid_clear();
+    scan_rows(tx, ty, GRID_TILE/2);
+    for(n = 1; n <= GRID_TILES; n++)
+        scan_rows(tx + n, ty + 4, 1);
+    HOST_CHECK(!grid_wasFree(x0, y0 + GRID_TILE - 1));
+    HOST_CHECK(grid_get(x0, y0 + GRID_TILE - 1) == GRID_UNEXPLORED);
+    HOST_CHECK(grid_get(x0, y0) == GRID_UNEXPLORED);//its scan is lost, never made up
+    scan_rows(tx, ty, 2);
+    HOST_CHECK(grid_get(x0, y0 + 2) == GRID_UNEXPLORED && grid_get(x0, y0 + GRID_TILE - 1) == GRID_UNEXPLORED);
+    frontier_update(x0, y0);
+    for(n = 0; n < frontier_count; n++)
+        if(frontiers[n].minX >= x0 && frontiers[n].maxX < x0 + GRID_TILE && frontiers[n].maxY == y0 + 1)
+            break;
+    HOST_CHECK(n < frontier_count);//the top row of the new scan
+}
+
+int main(void){
+    check_square();
+    check_evicted();
+    check_partial();
+    return host_report("frontier_test");
+}
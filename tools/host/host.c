@@ -0,0 +1,142 @@
+/**
+ * @file host.c
+ * @brief stand-ins for the cybot hardware the host harnesses link against, a simulated microsecond clock, a UART4
+ * fed from a buffer and a pass/fail check
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <time.h>
+#include "host.h"
+
+uint32_t host_micros = 0;
+int host_failures = 0;
+int host_checks = 0;
+//UART4 registers for the open interface, see stub/inc/tm4c123gh6pm.h
+volatile uint32_t host_uart4IM, host_uart4ICR, host_uart4Flags, host_uart4Data;
+const uint8_t *host_uart4Next, *host_uart4End;
+
+/**
+ * Record a check, use HOST_CHECK
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param ok 1 if the check passed
+ * @param cond the condition as text
+ * @param file source file of the check
+ * @param line line of the check
+ */
+void host_check(int ok, const char *cond, const char *file, int line){
+    host_checks++;
+    if(ok)
+        return;
+    host_failures++;
+    printf("%s:%d: check failed: %s\n", file, line, cond);
+}
+/**
+ * Print the result of a harness
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param name harness name
+ * @return exit status, 0 if every check passed
+ */
+int host_report(const char *name){
+    printf("%s: %d checks, %d failed\n", name, host_checks, host_failures);
+    return host_failures != 0;
+}
+/**
+ * Wall clock for timing code on the host, unrelated to host_micros
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return nanoseconds from an arbitrary start
+ */
+uint64_t host_nanos(void){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec*1000000000u + t.tv_nsec;
+}
+/**
+ * Queue bytes for UART4 to receive, UART4_Handler reads them until the queue is empty
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param data bytes
+ * @param n number of bytes
+ */
+void host_uart4Feed(const uint8_t *data, int n){
+    host_uart4Next = data;
+    host_uart4End = data + n;
+}
+/**
+ * UART4_FR_R on the host, the receive FIFO is empty once every fed byte was read and the transmitter is never full
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return flag register
+ */
+volatile uint32_t *host_uart4FR(void){
+    host_uart4Flags = host_uart4Next < host_uart4End ? 0 : 0x10;//UART_FR_RXFE
+    return &host_uart4Flags;
+}
+/**
+ * UART4_DR_R on the host, a read takes the next fed byte and writes are dropped
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return data register
+ */
+volatile uint32_t *host_uart4DR(void){
+    host_uart4Data = host_uart4Next < host_uart4End ? *host_uart4Next++ : 0;
+    return &host_uart4Data;
+}
+//timer.h, time only passes when a harness moves host_micros
+uint32_t timer_now(void){
+    return host_micros;
+}
+uint32_t timer_elapsed(uint32_t since){
+    return host_micros - since;
+}
+void timer_waitMillis(uint32_t millis){
+    host_micros += millis*1000;
+}
+void timer_waitMicros(uint16_t micros){
+    host_micros += micros;
+}
+//lcd.h and uart.h print to stdout
+void lcd_printf(const char *format, ...){
+    va_list args;
+    va_start(args, format);
+    printf("lcd: ");
+    vprintf(format, args);
+    printf("\n");
+    va_end(args);
+}
+void uart_sendStr(const char *data){
+    fputs(data, stdout);
+}
+void uart_sendChar(char data){
+    putchar(data);
+}
+int uart_sendAsync(const char *data, int len){
+    return fwrite(data, 1, len, stdout);
+}
+int uart_txFree(void){
+    return 1024;
+}
+//bench.h, the cycle counter itself is target only
+void bench_init(void){
+}
+//driverlib/interrupt.h
+void IntRegister(uint32_t ui32Interrupt, void (*pfnHandler)(void)){
+}
+bool IntMasterEnable(void){
+    return false;
+}
+bool IntMasterDisable(void){
+    return false;
+}
+void IntEnable(uint32_t ui32Interrupt){
+}
+void IntDisable(uint32_t ui32Interrupt){
+}
+void IntPrioritySet(uint32_t ui32Interrupt, uint8_t ui8Priority){
+}
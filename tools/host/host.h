@@ -0,0 +1,54 @@
+/**
+ * @file host.h
+ * @brief stand-ins for the cybot hardware the host harnesses link against, a simulated microsecond clock, a UART4
+ * fed from a buffer and a pass/fail check
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+
+#ifndef HOST_H_
+#define HOST_H_
+
+#include <stdint.h>
+
+extern uint32_t host_micros; //what timer_now returns, harnesses advance it to simulate time passing
+extern int host_failures; //checks that failed so far
+
+//record a check, a failure prints the condition and where it is
+#define HOST_CHECK(cond) host_check((cond) != 0, #cond, __FILE__, __LINE__)
+
+/**
+ * Record a check, use HOST_CHECK
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param ok 1 if the check passed
+ * @param cond the condition as text
+ * @param file source file of the check
+ * @param line line of the check
+ */
+void host_check(int ok, const char *cond, const char *file, int line);
+/**
+ * Print the result of a harness
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param name harness name
+ * @return exit status, 0 if every check passed
+ */
+int host_report(const char *name);
+/**
+ * Wall clock for timing code on the host, unrelated to host_micros
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @return nanoseconds from an arbitrary start
+ */
+uint64_t host_nanos(void);
+/**
+ * Queue bytes for UART4 to receive, UART4_Handler reads them until the queue is empty
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param data bytes
+ * @param n number of bytes
+ */
+void host_uart4Feed(const uint8_t *data, int n);
+
+#endif /* HOST_H_ */
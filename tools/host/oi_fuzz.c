@@ -0,0 +1,263 @@
+/**
+ * @file oi_fuzz.c
+ * @brief host fuzz of the open interface stream parser, random and corrupted byte streams go through UART4_Handler and
+ * oi_update, decoded fields are checked against a plain big-endian decode, then oi_parsePacket is timed
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "open_interface.h"
+#include "host.h"
+
+#define GROUP100_SIZE 80
+#define STREAM_HEADER 19
+#define FRAME_QUEUE 4
+
+//internal to open_interface.c
+void UART4_Handler(void);
+void oi_fieldsInit(void);
+void oi_streamStart(void);
+void oi_parsePacket(oi_t *self, uint8_t packet[]);
+uint8_t oi_sizeOf(uint8_t id);
+extern volatile uint8_t oi_frameHead, oi_frameTail;
+extern volatile uint32_t oi_frameErrors, oi_framesDropped;
+
+oi_t sensors;
+uint8_t frame[GROUP100_SIZE + 4];
+
+/**
+ * Byte offset of a packet in group 100
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param id packet id 7-58
+ * @return offset
+ */
+int packet_offset(int id){
+    int n, offset = 0;
+    for(n = 7; n < id; n++)
+        offset += oi_sizeOf(n);
+    return offset;
+}
+/**
+ * Big-endian 16 bit value
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param data first byte
+ * @return value
+ */
+int be16(const uint8_t *data){
+    return data[0] << 8 | data[1];
+}
+/**
+ * Wrap a stream frame body as [19][n][body][checksum]
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param body frame body
+ * @param n body length
+ * @return frame length
+ */
+int make_frame(const uint8_t *body, int n){
+    uint8_t sum = STREAM_HEADER + n;
+    int i;
+    frame[0] = STREAM_HEADER;
+    frame[1] = n;
+    for(i = 0; i < n; i++){
+        frame[2 + i] = body[i];
+        sum += body[i];
+    }
+    frame[2 + n] = -sum;
+    return n + 3;
+}
+/**
+ * Receive bytes through the interrupt handler
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param data bytes
+ * @param n number of bytes
+ */
+void receive(const uint8_t *data, int n){
+    host_uart4Feed(data, n);
+    UART4_Handler();
+}
+/**
+ * Random group 100 frames decode to the same values as reading the packet bytes directly
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void check_group100(void){
+    uint8_t body[GROUP100_SIZE + 1];
+    uint8_t *p = body + 1;
+    int n, i, bad = 0;
+    body[0] = 100;
+    for(n = 0; n < 2000; n++){
+        for(i = 0; i < GROUP100_SIZE; i++)
+            p[i] = rand();
+        receive(frame, make_frame(body, sizeof(body)));
+        oi_update(&sensors);
+        bad += sensors.bumpLeft != !!(p[0] & 2) || sensors.bumpRight != !!(p[0] & 1);
+        bad += sensors.cliffFrontLeft != p[packet_offset(10)];
+        bad += sensors.distance != (int16_t)be16(p + packet_offset(19));
+        bad += sensors.batteryCharge != be16(p + packet_offset(25));
+        bad += sensors.cliffRightSignal != be16(p + packet_offset(31));
+        bad += sensors.requestedVelocity != (int16_t)be16(p + packet_offset(39));
+        bad += sensors.leftEncoderCount != be16(p + packet_offset(43));
+        bad += sensors.rightEncoderCount != be16(p + packet_offset(44));
+        bad += sensors.lightBumperCenterLeft != !!(p[packet_offset(45)] & 4);
+        bad += sensors.sideBrushMotorCurrent != (int16_t)be16(p + packet_offset(57));
+        bad += sensors.stasis != p[packet_offset(58)];
+    }
+    HOST_CHECK(bad == 0);
+    HOST_CHECK(oi_frameErrors == 0);
+    //fields outside the mask keep their value
+    oi_setFieldMask(OI_FIELDS_BUMP);
+    i = sensors.cliffFrontLeft;
+    p[packet_offset(10)] = i + 1;
+    p[0] ^= 3;
+    receive(frame, make_frame(body, sizeof(body)));
+    oi_update(&sensors);
+    HOST_CHECK(sensors.cliffFrontLeft == i);
+    HOST_CHECK(sensors.bumpRight == !!(p[0] & 1));
+    oi_setFieldMask(OI_FIELDS_ALL);
+}
+/**
+ * Frames the queue has no room for still count, and so does their distance
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void check_dropped(void){
+    uint8_t body[GROUP100_SIZE + 1] = {100};
+    int n, d, total = 0;
+    uint32_t dropped = oi_framesDropped;
+    for(n = 0; n < 7; n++){
+        d = rand() % 200 - 100;
+        total += d;
+        body[1 + packet_offset(19)] = d >> 8;
+        body[1 + packet_offset(19) + 1] = d;
+        receive(frame, make_frame(body, sizeof(body)));
+    }
+    HOST_CHECK(oi_update(&sensors) == 7);//dropped frames count, their distance is there
+    HOST_CHECK(oi_framesDropped - dropped == 7 - (FRAME_QUEUE - 1));
+    HOST_CHECK(sensors.distance == total);
+    HOST_CHECK(oi_update(&sensors) == 0 && sensors.distance == 0);
+}
+/**
+ * A shorter sensor list, and bodies that don't match the packet table, which are dropped part way
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void check_list(void){
+    const uint8_t list[] = {7, 19, 43, 44};
+    uint8_t body[] = {7, 0x02, 19, 0xFF, 0x38, 43, 0x12, 0x34, 44, 0xAB, 0xCD};
+    HOST_CHECK(oi_setSensorList(list, sizeof(list)) == 0);
+    receive(frame, make_frame(body, sizeof(body)));
+    oi_update(&sensors);
+    HOST_CHECK(sensors.bumpLeft == 1 && sensors.bumpRight == 0);
+    HOST_CHECK(sensors.distance == -200);
+    HOST_CHECK(sensors.leftEncoderCount == 0x1234 && sensors.rightEncoderCount == 0xABCD);
+    body[5] = 99;//unknown id, the rest of the frame is skipped
+    body[7] = 0x56;
+    receive(frame, make_frame(body, sizeof(body)));
+    oi_update(&sensors);
+    HOST_CHECK(sensors.leftEncoderCount == 0x1234);
+    HOST_CHECK(sensors.distance == -200);
+    body[5] = 43;
+    receive(frame, make_frame(body, 7));//cut inside the encoder packet
+    oi_update(&sensors);
+    HOST_CHECK(sensors.leftEncoderCount == 0x1234);
+}
+/**
+ * One corrupted byte in a frame is caught by the checksum
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void check_corrupt(void){
+    uint8_t body[GROUP100_SIZE + 1] = {100};
+    uint8_t idle[GROUP100_SIZE + 2] = {0};//ends any frame a corrupt length started
+    int n, i, len, published = 0, trials = 20000;
+    for(n = 0; n < trials; n++){
+        for(i = 1; i < (int)sizeof(body); i++)
+            body[i] = rand();
+        len = make_frame(body, sizeof(body));
+        i = 1 + rand() % (len - 1);//not the header, a frame without one is just ignored
+        frame[i] ^= 1 + rand() % 255;
+        receive(frame, len);
+        receive(idle, sizeof(idle));
+        published += oi_frameHead != oi_frameTail;
+        oi_update(&sensors);
+    }
+    printf("corrupt frames published %d of %d\n", published, trials);
+    HOST_CHECK(published < trials/100);
+}
+/**
+ * Random bytes with valid frames mixed in, the queue indexes stay in range and a clean frame still parses after
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void check_noise(void){
+    static uint8_t noise[1 << 16];
+    uint8_t body[GROUP100_SIZE + 1] = {100};
+    uint8_t idle[GROUP100_SIZE + 2] = {0};
+    int n, i, at, len;
+    for(i = 0; i < (int)sizeof(noise); i++)
+        noise[i] = rand() % 4 ? rand() : STREAM_HEADER;
+    for(n = 0; n < 200; n++){
+        for(at = 0; at < (int)sizeof(noise); at += len){
+            len = 1 + rand() % 100;
+            if(at + len > (int)sizeof(noise))
+                len = sizeof(noise) - at;
+            receive(noise + at, len);
+            if(rand() % 8 == 0)
+                receive(frame, make_frame(body, 1 + rand() % GROUP100_SIZE));
+            HOST_CHECK(oi_frameHead < FRAME_QUEUE && oi_frameTail < FRAME_QUEUE);
+            oi_update(&sensors);
+        }
+        for(i = 0; i < (int)sizeof(noise); i++)
+            noise[i] = rand() % 4 ? rand() : STREAM_HEADER;
+    }
+    receive(idle, sizeof(idle));
+    body[1 + packet_offset(43)] = 0x42;
+    body[1 + packet_offset(43) + 1] = 0x24;
+    receive(frame, make_frame(body, sizeof(body)));
+    oi_update(&sensors);
+    HOST_CHECK(sensors.leftEncoderCount == 0x4224);
+}
+/**
+ * Time oi_parsePacket on a group 100 packet with every field and with the mask main uses, the host only shows the
+ * ratio, oi_parseBench ('B') gives cycles on the cybot
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void bench_parse(void){
+    uint8_t packet[GROUP100_SIZE];
+    uint64_t start, all, masked;
+    int n;
+    for(n = 0; n < GROUP100_SIZE; n++)
+        packet[n] = rand();
+    oi_setFieldMask(OI_FIELDS_ALL);
+    start = host_nanos();
+    for(n = 0; n < 1000000; n++)
+        oi_parsePacket(&sensors, packet);
+    all = host_nanos() - start;
+    oi_setFieldMask(OI_FIELDS_BUMP | OI_FIELDS_CLIFF | OI_FIELDS_CLIFF_SIGNAL | OI_FIELDS_MOTION | OI_FIELDS_BATTERY);
+    start = host_nanos();
+    for(n = 0; n < 1000000; n++)
+        oi_parsePacket(&sensors, packet);
+    masked = host_nanos() - start;
+    printf("oi_parsePacket all fields %.1f ns, main's mask %.1f ns\n", all/1e6, masked/1e6);
+    oi_setFieldMask(OI_FIELDS_ALL);
+}
+
+int main(void){
+    srand(1);
+    oi_fieldsInit();
+    oi_streamStart();
+    check_group100();
+    check_dropped();
+    check_corrupt();
+    check_noise();
+    check_list();
+    bench_parse();
+    return host_report("oi_fuzz");
+}
@@ -0,0 +1,196 @@
+/**
+ * @file planner_test.c
+ * @brief host test of the A* planner against a plain Dijkstra search of the same window, on random clutter and a few
+ * hand made traps, every path must be the shortest, also reports how full the open set gets
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "planner.h"
+#include "host.h"
+
+extern int plan_x0, plan_y0;
+
+uint8_t blocked[PLAN_SIZE][PLAN_SIZE];
+uint32_t dist[PLAN_SIZE][PLAN_SIZE];
+uint8_t done[PLAN_SIZE][PLAN_SIZE];
+int worstPeak = 0;
+double worstRatio = 1, sumRatio = 0;
+int paths = 0;
+
+/**
+ * Block the window cells the planner should treat as obstacles, same clearance rule as plan_markObstacles
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param sx start column in the window, never blocked
+ * @param sy start row in the window
+ */
+void mark_blocked(int sx, int sy){
+    int x, y, dx, dy, v;
+    memset(blocked, 0, sizeof(blocked));
+    for(y = -PLAN_RADIUS; y < PLAN_SIZE + PLAN_RADIUS; y++)
+        for(x = -PLAN_RADIUS; x < PLAN_SIZE + PLAN_RADIUS; x++){
+            v = grid_get(plan_x0 + x, plan_y0 + y);
+            if(v <= GRID_FREE)
+                continue;
+            for(dy = -PLAN_RADIUS; dy <= PLAN_RADIUS; dy++)
+                for(dx = -PLAN_RADIUS; dx <= PLAN_RADIUS; dx++)
+                    if(dx*dx + dy*dy <= PLAN_RADIUS*PLAN_RADIUS + 1 && x + dx >= 0 && x + dx < PLAN_SIZE && y + dy >= 0 && y + dy < PLAN_SIZE)
+                        blocked[y + dy][x + dx] = 1;
+        }
+    blocked[sy][sx] = 0;
+}
+/**
+ * Cost of the best path in the window with the same moves as the planner, O(n^2) Dijkstra
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param sx start column in the window
+ * @param sy start row in the window
+ * @param gx goal column in the window
+ * @param gy goal row in the window
+ * @return cost, UINT32_MAX if there is no path
+ */
+uint32_t best_cost(int sx, int sy, int gx, int gy){
+    static const int dx[8] = {1, 0, -1, 0, 1, -1, -1, 1}, dy[8] = {0, 1, 0, -1, 1, 1, -1, -1};
+    int x, y, bx = 0, by = 0, d, nx, ny;
+    uint32_t best, c;
+    memset(dist, 0xFF, sizeof(dist));
+    memset(done, 0, sizeof(done));
+    dist[sy][sx] = 0;
+    for(;;){
+        best = UINT32_MAX;
+        for(y = 0; y < PLAN_SIZE; y++)
+            for(x = 0; x < PLAN_SIZE; x++)
+                if(!done[y][x] && dist[y][x] < best){
+                    best = dist[y][x];
+                    bx = x;
+                    by = y;
+                }
+        if(best == UINT32_MAX || (bx == gx && by == gy))
+            return best;
+        done[by][bx] = 1;
+        for(d = 0; d < 8; d++){
+            nx = bx + dx[d];
+            ny = by + dy[d];
+            if(nx < 0 || nx >= PLAN_SIZE || ny < 0 || ny >= PLAN_SIZE || blocked[ny][nx])
+                continue;
+            if(d >= 4 && (blocked[by][nx] || blocked[ny][bx]))
+                continue;
+            c = best + (d < 4 ? PLAN_STRAIGHT : PLAN_DIAGONAL);
+            if(c < dist[ny][nx])
+                dist[ny][nx] = c;
+        }
+    }
+}
+/**
+ * Plan and compare with the best path, the waypoints must be joined by straight or diagonal runs of clear cells
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param name case name
+ * @param x0 start cell column
+ * @param y0 start cell row
+ * @param x1 goal cell column
+ * @param y1 goal cell row
+ */
+void run(const char *name, int x0, int y0, int x1, int y1){
+    int n = plan_find(x0, y0, x1, y1), i, x, y, tx, ty, ok = 1;
+    uint32_t best;
+    double ratio;
+    mark_blocked(x0 - plan_x0, y0 - plan_y0);
+    best = best_cost(x0 - plan_x0, y0 - plan_y0, x1 - plan_x0, y1 - plan_y0);
+    if((int)plan_peak > worstPeak)
+        worstPeak = plan_peak;
+    if(blocked[y1 - plan_y0][x1 - plan_x0]){
+        HOST_CHECK(n == PLAN_BLOCKED);
+        return;
+    }
+    if(best == UINT32_MAX){
+        HOST_CHECK(n == PLAN_NONE);
+        return;
+    }
+    HOST_CHECK(n > 0);
+    if(n <= 0){
+        printf("%s: no path, best is %u\n", name, (unsigned)best);
+        return;
+    }
+    x = x0;
+    y = y0;
+    for(i = 0; i < n; i++){
+        tx = plan_path[i].x;
+        ty = plan_path[i].y;
+        ok &= tx == x || ty == y || abs(tx - x) == abs(ty - y);
+        while(x != tx || y != ty){
+            x += (tx > x) - (tx < x);
+            y += (ty > y) - (ty < y);
+            ok &= !blocked[y - plan_y0][x - plan_x0];
+        }
+    }
+    HOST_CHECK(ok);
+    HOST_CHECK(n == PLAN_MAX_POINTS || (x == x1 && y == y1));//a longer path keeps its first PLAN_MAX_POINTS
+    HOST_CHECK(plan_cost == best);//A* with a consistent heuristic finds the shortest path
+    ratio = (double)plan_cost/best;
+    if(ratio > worstRatio)
+        worstRatio = ratio;
+    sumRatio += ratio;
+    paths++;
+}
+/**
+ * Start and goal are in the window at every distance plan_find takes, and PLAN_FAR past it
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void check_window(void){
+    int d, e, bad = 0, r;
+    grid_clear();
+    for(d = -PLAN_SIZE; d <= PLAN_SIZE; d++)
+        for(e = -2; e <= 2; e++){
+            r = plan_find(GRID_ORIGIN, GRID_ORIGIN, GRID_ORIGIN + d, GRID_ORIGIN + e);
+            if(abs(d) > PLAN_SIZE - 1){
+                bad += r != PLAN_FAR;
+                continue;
+            }
+            bad += r < 0 && d;
+            bad += GRID_ORIGIN + d - plan_x0 < 0 || GRID_ORIGIN + d - plan_x0 >= PLAN_SIZE;
+            bad += GRID_ORIGIN - plan_x0 < 0 || GRID_ORIGIN - plan_x0 >= PLAN_SIZE;
+        }
+    HOST_CHECK(bad == 0);
+}
+
+int main(void){
+    int i, k, o = GRID_ORIGIN;
+    check_window();
+
+    grid_clear();
+    run("open diagonal", o, o, o + PLAN_SIZE - 1, o + PLAN_SIZE - 1);
+    run("open straight", o, o, o + PLAN_SIZE - 1, o);
+    for(i = 0; i < 40; i++)
+        grid_set(o + 30, o + i, GRID_OBJECT);
+    run("wall", o + 20, o + 24, o + 40, o + 24);
+    grid_clear();
+    for(i = 0; i < 30; i++){//U opening away from the goal
+        grid_set(o + 50, o + 10 + i, GRID_OBJECT);
+        grid_set(o + 20 + i, o + 10, GRID_OBJECT);
+        grid_set(o + 20 + i, o + 39, GRID_OBJECT);
+    }
+    run("trap", o + 35, o + 25, o + 60, o + 25);
+    grid_clear();
+    for(i = 0; i < 56; i++){
+        grid_set(o + 10 + i, o + 20, GRID_OBJECT);
+        grid_set(o + i, o + 40, GRID_OBJECT);
+    }
+    run("zigzag", o + 30, o + 5, o + 30, o + 60);
+    srand(1);
+    for(k = 0; k < 60; k++){
+        grid_clear();
+        for(i = 0; i < 40 + k*2; i++)
+            grid_set(o + rand() % PLAN_SIZE, o + rand() % PLAN_SIZE, GRID_OBJECT);
+        run("clutter", o + 1, o + 1, o + PLAN_SIZE - 2, o + PLAN_SIZE - 2);
+        run("clutter", o + 1, o + PLAN_SIZE - 2, o + PLAN_SIZE - 2, o + 1);
+    }
+    printf("%d paths, cost over the best path mean %.3f worst %.3f, open set peak %d of %d\n",
+           paths, sumRatio/paths, worstRatio, worstPeak, PLAN_HEAP);
+    HOST_CHECK(worstPeak < PLAN_HEAP*3/4);//cells pushed again on a cheaper route take room too
+    return host_report("planner_test");
+}
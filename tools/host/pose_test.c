@@ -0,0 +1,107 @@
+/**
+ * @file pose_test.c
+ * @brief host test of the single precision pose math, a long drive integrated by odo_move next to the double precision
+ * update_position code it replaced, then both timed
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "odometry.h"
+#include "host.h"
+
+#define START 1024 //start cell on both axes, where main puts the cybot
+#define FRAMES 240000 //an hour of 15 ms frames
+#define CALLS 10000000 //calls timed
+
+/**
+ * The double precision update_position math odo_move replaced, as draw_mathBench keeps it
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param x cell column
+ * @param y cell row
+ * @param heading ccw from +x in degrees
+ * @param d mm driven
+ * @param turned degrees turned ccw
+ */
+void double_move(double *x, double *y, double *heading, double d, double turned){
+    double mid = *heading + turned/2;
+    *x += d*cos(0.017453292519943*mid)/100;
+    *y += d*sin(0.017453292519943*mid)/100;
+    *heading += turned;
+    while(*heading >= 360)
+        *heading -= 360;
+    while(*heading < 0)
+        *heading += 360;
+}
+/**
+ * An hour of driving at up to 200 mm/s with turns, odo_move stays within 2 cm and half a degree of double precision,
+ * far less than the encoders themselves drift
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void check_drive(void){
+    odo_pose_t pose = {START, START, 90};
+    double x = START, y = START, heading = 90, d, turned, err, worst = 0, worstHeading = 0, travelled = 0;
+    int n;
+    srand(1);
+    for(n = 0; n < FRAMES; n++){
+        if(n % 400 < 300){//drive, then turn on the spot
+            d = rand() % 3000/1000.0;
+            turned = (rand() % 201 - 100)/2000.0;
+        }else{
+            d = 0;
+            turned = n % 800 < 400 ? 0.7 : -0.9;
+        }
+        odo_move(&pose, d, turned);
+        double_move(&x, &y, &heading, d, turned);
+        travelled += d;
+        err = hypot(pose.x - x, pose.y - y)*100;
+        if(err > worst)
+            worst = err;
+        err = fabs(remainder(pose.heading - heading, 360));
+        if(err > worstHeading)
+            worstHeading = err;
+    }
+    printf("%.0f m driven: float within %.2f mm and %.4f deg of double\n", travelled/1000, worst, worstHeading);
+    HOST_CHECK(worst < 20);
+    HOST_CHECK(worstHeading < 0.5);
+    HOST_CHECK(pose.heading >= 0 && pose.heading < 360);
+}
+/**
+ * Time odo_move against the double code, on the host this only shows the ratio, draw_mathBench ('f') gives cycles on
+ * the cybot
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void bench(void){
+    odo_pose_t pose = {START, START, 90};
+    volatile double x = START, y = START, heading = 90;
+    double dx, dy, dh;
+    volatile float d = 1.5f;
+    uint64_t start, single, twice;
+    int n;
+    start = host_nanos();
+    for(n = 0; n < CALLS; n++)
+        odo_move(&pose, d, d);
+    single = host_nanos() - start;
+    start = host_nanos();
+    for(n = 0; n < CALLS; n++){
+        dx = x;
+        dy = y;
+        dh = heading;
+        double_move(&dx, &dy, &dh, d, d);
+        x = dx;
+        y = dy;
+        heading = dh;
+    }
+    twice = host_nanos() - start;
+    printf("pose step\tfloat %.1f ns\tdouble %.1f ns\n", (double)single/CALLS, (double)twice/CALLS);
+}
+
+int main(void){
+    check_drive();
+    bench();
+    return host_report("pose_test");
+}
@@ -0,0 +1,34 @@
+#!/bin/sh
+# Build and run the host harnesses, all of them or the ones named: tools/host/run.sh [harness...]
+# The firmware sources build unchanged with gcc, stub/ stands in for the TivaWare headers and host.c for the hardware.
+# Everything is built with the address and undefined behaviour sanitizers, a harness exits nonzero if a check fails.
+cd "$(dirname "$0")/../.." || exit 1
+out=${HOST_OUT:-/tmp/cybot_host}
+mkdir -p "$out" || exit 1
+flags="-std=gnu99 -O1 -g -Wall -fsanitize=address,undefined -fno-sanitize-recover=undefined"
+#timer.h defines its own clock_t, keep glibc's out of the firmware sources
+firmware="$flags -D__clock_t_defined -Itools/host/stub -Itools/host -I."
+gcc $flags -c tools/host/host.c -o "$out/host.o" || exit 1
+
+build(){
+    name=$1
+    shift
+    gcc $firmware "$@" "$out/host.o" -lm -o "$out/$name"
+}
+
+status=0
+for harness in ${@:-store_test oi_fuzz frontier_test planner_test control_sim ekf_sim fixmath_test pose_test}; do
+    case $harness in
+        store_test) build store_test -DSTORE_RAM tools/host/store_test.c store.c map.c grid.c occupancy.c telemetry.c fixmath.c ;;
+        oi_fuzz) build oi_fuzz -DHOST_UART4 tools/host/oi_fuzz.c open_interface.c ;;
+        frontier_test) build frontier_test tools/host/frontier_test.c frontier.c grid.c fixmath.c ;;
+        planner_test) build planner_test tools/host/planner_test.c planner.c grid.c ;;
+        control_sim) build control_sim tools/host/control_sim.c control.c odometry.c fixmath.c ;;
+        ekf_sim) build ekf_sim tools/host/ekf_sim.c ekf.c odometry.c fixmath.c ;;
+        fixmath_test) build fixmath_test tools/host/fixmath_test.c fixmath.c ;;
+        pose_test) build pose_test tools/host/pose_test.c odometry.c fixmath.c ;;
+        *) echo "unknown harness $harness"; false ;;
+    esac || { status=1; continue; }
+    "$out/$harness" || status=1
+done
+exit $status
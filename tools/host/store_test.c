@@ -0,0 +1,122 @@
+/**
+ * @file store_test.c
+ * @brief host test of the record store and map checkpoints, built with STORE_RAM so the EEPROM is a RAM array
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+#include <stdio.h>
+#include <string.h>
+#include "store.h"
+#include "map.h"
+#include "host.h"
+
+#define AREA 48 //cells along each side of the area compared
+
+extern uint32_t store_ram[STORE_WORDS];
+uint8_t saved[2][AREA][AREA];
+
+/**
+ * Copy the cells around the origin
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ * @param cells filled with the cell values
+ */
+void grab(uint8_t cells[AREA][AREA]){
+    int x, y;
+    for(y = 0; y < AREA; y++)
+        for(x = 0; x < AREA; x++)
+            cells[y][x] = grid_get(GRID_ORIGIN - AREA/2 + x, GRID_ORIGIN - AREA/2 + y);
+}
+/**
+ * Records round trip, and every slot of the ring gets used
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void check_records(void){
+    const store_region_t *r = &store_regions[STORE_CAL];
+    int n, v, slots = 0;
+    float pose[3] = {1024.5f, 1030.25f, 90}, back[3];
+    HOST_CHECK(store_open(STORE_CAL) < 0);
+    for(n = 0; n < 10; n++)
+        HOST_CHECK(store_write(STORE_CAL, &n, sizeof(n)));
+    HOST_CHECK(store_read(STORE_CAL, &v, sizeof(v)) && v == 9);
+    for(n = 0; n < r->slots; n++)
+        slots += store_ram[r->first + n*r->slotWords] != 0;
+    HOST_CHECK(slots == r->slots);
+    //regions don't overlap
+    HOST_CHECK(store_write(STORE_POSE, pose, sizeof(pose)));
+    HOST_CHECK(store_read(STORE_POSE, back, sizeof(back)) && !memcmp(pose, back, sizeof(pose)));
+    HOST_CHECK(store_read(STORE_CAL, &v, sizeof(v)) && v == 9);
+    //a record of the wrong size is not read
+    HOST_CHECK(!store_read(STORE_POSE, &v, sizeof(v)));
+}
+/**
+ * A write that never reaches store_end, or that overflows, leaves the previous record
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void check_interrupted(void){
+    uint8_t big[200] = {0};
+    int v = 77;
+    store_begin(STORE_CAL);
+    store_put(&v, sizeof(v));//reset here, no store_end
+    HOST_CHECK(store_read(STORE_CAL, &v, sizeof(v)) && v == 9);
+    store_begin(STORE_CAL);
+    HOST_CHECK(!store_put(big, sizeof(big)));
+    HOST_CHECK(!store_end());
+    HOST_CHECK(store_read(STORE_CAL, &v, sizeof(v)) && v == 9);
+}
+/**
+ * Map checkpoints round trip, and a corrupted newest checkpoint falls back to the one before
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+void check_map(void){
+    static uint8_t now[AREA][AREA];
+    const store_region_t *r = &store_regions[STORE_MAP];
+    int n, k, tiles, found[2];
+    grid_clear();
+    for(n = 0; n < 9; n++){//a fan of IR rays, the middle one hitting an object
+        map_castRay(GRID_ORIGIN, GRID_ORIGIN, GRID_ORIGIN - 16 + 4*n, GRID_ORIGIN + 12, OCC_IR, n == 4);
+        map_castRay(GRID_ORIGIN, GRID_ORIGIN, GRID_ORIGIN - 16 + 4*n, GRID_ORIGIN + 12, OCC_IR, n == 4);
+    }
+    grid_set(GRID_ORIGIN - 20, GRID_ORIGIN - 20, GRID_CLIFF);
+    tiles = grid_tilesUsed();
+    HOST_CHECK(map_save() == tiles);
+    grab(saved[0]);
+    grid_set(GRID_ORIGIN + 10, GRID_ORIGIN - 5, GRID_BUMP);
+    HOST_CHECK(map_save() == grid_tilesUsed());
+    grab(saved[1]);
+    HOST_CHECK(memcmp(saved[0], saved[1], sizeof(saved[0])));
+
+    grid_clear();
+    HOST_CHECK(map_load() == grid_tilesUsed());
+    grab(now);
+    HOST_CHECK(!memcmp(now, saved[1], sizeof(now)));
+    HOST_CHECK(grid_get(GRID_ORIGIN - 20, GRID_ORIGIN - 20) == GRID_CLIFF);
+
+    //flip a payload word in each slot in turn, the other slot must be the one loaded
+    for(k = 0; k < r->slots; k++){
+        store_ram[r->first + k*r->slotWords + 3] ^= 1;
+        grid_clear();
+        HOST_CHECK(map_load() > 0);
+        grab(now);
+        found[k] = !memcmp(now, saved[0], sizeof(now)) ? 0 : !memcmp(now, saved[1], sizeof(now)) ? 1 : -1;
+        store_ram[r->first + k*r->slotWords + 3] ^= 1;
+    }
+    HOST_CHECK(found[0] >= 0 && found[1] >= 0 && found[0] != found[1]);
+    for(k = 0; k < r->slots; k++)
+        store_ram[r->first + k*r->slotWords + 3] ^= 1;
+    HOST_CHECK(store_open(STORE_MAP) < 0);
+    grid_clear();
+    HOST_CHECK(map_load() < 0);
+}
+
+int main(void){
+    HOST_CHECK(store_init());
+    check_records();
+    check_interrupted();
+    check_map();
+    printf("capacity cal %d pose %d map %d bytes\n", store_capacity(STORE_CAL), store_capacity(STORE_POSE), store_capacity(STORE_MAP));
+    return host_report("store_test");
+}
@@ -0,0 +1,7 @@
+/**
+ * @file Timer.h
+ * @brief host build shim, the sources include "Timer.h" but the header is timer.h, which only matters off Windows
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+#include "../../../timer.h"
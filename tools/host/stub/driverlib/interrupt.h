@@ -0,0 +1,21 @@
+/**
+ * @file interrupt.h
+ * @brief host build stand-in for the TivaWare interrupt API, host.c defines these as no-ops
+ * @author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+ * @date 12/2/2018
+ */
+
+#ifndef HOST_INTERRUPT_H_
+#define HOST_INTERRUPT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+void IntRegister(uint32_t ui32Interrupt, void (*pfnHandler)(void));
+bool IntMasterEnable(void);
+bool IntMasterDisable(void);
+void IntEnable(uint32_t ui32Interrupt);
+void IntDisable(uint32_t ui32Interrupt);
+void IntPrioritySet(uint32_t ui32Interrupt, uint8_t ui8Priority);
+
+#endif /* HOST_INTERRUPT_H_ */
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""
+@file tele_decode.py
+@brief host decoder for the telemetry.h frames the cybot sends in binary mode ('n')
+@author Jordan Fox, Scott Beard, Daksh Goel, James Volpe
+@date 12/2/2018
+
+usage: tele_decode.py [capture or serial device], reads stdin if none is given
+text the cybot sends between frames (echo, $M map rows) is passed through unchanged
+"""
+import struct
+import sys
+
+TELE_SYNC = 0xA5
+TELE_POSE, TELE_HAZARD, TELE_SWEEP, TELE_OBJECTS, TELE_BATTERY = 1, 2, 3, 4, 5
+HAZARDS = ["object imminent", "cliff", "edge", "bump"]
+SIDES = ["Right", "Front Right", "Front Left", "Left"]
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16/CCITT, polynomial 0x1021, same as tele_crc"""
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021 if crc & 0x8000 else crc << 1) & 0xFFFF
+    return crc
+
+
+def describe(kind, p):
+    """Render one payload as a line of text"""
+    if kind == TELE_POSE and len(p) == 10:
+        x, y, h, t = struct.unpack("<hhhI", p)
+        return "pose %d ms (%.1f,%.1f) dm %.1f deg" % (t, x / 10, y / 10, h / 10)
+    if kind == TELE_HAZARD and len(p) == 6:
+        k, sides, x, y = struct.unpack("<BBhh", p)
+        names = [SIDES[i] for i in range(3, -1, -1) if sides & (1 << i)]
+        name = HAZARDS[k] if k < len(HAZARDS) else "hazard %d" % k
+        return "%s %s at (%.1f,%.1f) dm" % (name, ",".join(names), x / 10, y / 10)
+    if kind == TELE_SWEEP and len(p) >= 2 and len(p) == 2 + 2 * p[1]:
+        first, count = p[0], p[1]
+        ir, ping = p[2:2 + count], p[2 + count:]
+        return "\n".join("sweep %d\t%d\t%d" % (first + i, ir[i], ping[i]) for i in range(count))
+    if kind == TELE_OBJECTS and len(p) >= 1 and len(p) == 1 + 4 * p[0]:
+        lines = ["objects %d" % p[0]]
+        for n in range(p[0]):
+            a1, a2, dist, width = p[1 + 4 * n:5 + 4 * n]
+            lines.append("object %d %d-%d deg %d cm width %d cm" % (n, a1, a2, dist, width))
+        return "\n".join(lines)
+    if kind == TELE_BATTERY and len(p) == 4:
+        return "battery %d/%d" % struct.unpack("<HH", p)
+    return "type %d: %s" % (kind, p.hex())
+
+
+def decode(stream, out):
+    """Split a byte stream into frames and text, resynchronizing on the next sync byte after a bad crc"""
+    buf = bytearray()
+    stats = {"frames": 0, "bad": 0}
+    done = False
+    while not done:
+        chunk = stream.read(1)
+        done = not chunk
+        buf += chunk
+        while buf:
+            if buf[0] != TELE_SYNC:
+                out.write(chr(buf.pop(0)))
+                continue
+            if len(buf) < 3 or len(buf) < buf[2] + 5:
+                if not done:
+                    break  # wait for the rest of the frame
+                stats["bad"] += 1
+                del buf[0]  # cut short by the end of the capture
+                continue
+            n = buf[2]
+            frame = bytes(buf[:n + 5])
+            if crc16(frame[1:n + 3]) != frame[n + 3] | frame[n + 4] << 8:
+                stats["bad"] += 1
+                del buf[0]  # not a frame after all, search again from the next byte
+                continue
+            stats["frames"] += 1
+            out.write("\n" + describe(frame[1], frame[3:n + 3]) + "\n")
+            del buf[:n + 5]
+        out.flush()
+    return stats
+
+
+if __name__ == "__main__":
+    src = open(sys.argv[1], "rb", buffering=0) if len(sys.argv) > 1 else sys.stdin.buffer
+    s = decode(src, sys.stdout)
+    sys.stderr.write("%d frames, %d crc errors\n" % (s["frames"], s["bad"]))
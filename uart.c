@@ -6,6 +6,73 @@
  */
 #define baud 115200
 #include "uart.h"
+#include <stdbool.h>
+#include <string.h>
+#include "driverlib/interrupt.h"
+
+#define UART_RX_SIZE 128 //must be a power of 2
+#define UART_TX_SIZE 1024 //must be a power of 2
+
+//receive ring buffer, only the interrupt writes rxHead and only the foreground writes rxTail
+volatile char rxBuffer[UART_RX_SIZE];
+volatile uint32_t rxHead = 0;
+volatile uint32_t rxTail = 0;
+
+//transmit ring buffer, only the foreground writes txHead, txTail is written by whoever holds the transmit interrupt
+volatile char txBuffer[UART_TX_SIZE];
+volatile uint32_t txHead = 0;
+volatile uint32_t txTail = 0;
+
+volatile uint32_t uart_overrunErrors = 0;
+volatile uint32_t uart_framingErrors = 0;
+volatile uint32_t uart_rxDropped = 0;
+
+/**
+ * Move queued characters into the transmit FIFO until it is full or the queue is empty
+ * Only call from the interrupt or with the transmit interrupt masked
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ */
+void uart_txFill(void){
+    uint32_t tail = txTail;
+    while(tail != txHead && !(UART1_FR_R & UART_FR_TXFF)){
+        UART1_DR_R = txBuffer[tail];
+        tail = (tail + 1) & (UART_TX_SIZE - 1);
+    }
+    txTail = tail;
+}
+/**
+ * Uart1 interrupt, refill the transmit FIFO and move every received byte from the FIFO into the receive ring buffer
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ */
+void UART1_Handler(void){
+    uint32_t data;
+    uint32_t next;
+    if(UART1_MIS_R & UART_MIS_TXMIS){//transmit FIFO drained below 1/8
+        UART1_ICR_R = UART_ICR_TXIC;
+        uart_txFill();
+    }
+    //clear receive, receive timeout and error interrupts
+    UART1_ICR_R = (UART_ICR_RXIC | UART_ICR_RTIC | UART_ICR_OEIC | UART_ICR_FEIC);
+    while(!(UART1_FR_R & UART_FR_RXFE)){//empty the FIFO
+        //data register also holds the error flags for this byte
+        data = UART1_DR_R;
+        if(data & UART_DR_OE)
+            uart_overrunErrors++;
+        if(data & UART_DR_FE){
+            uart_framingErrors++;
+            continue;//byte is garbage
+        }
+        next = (rxHead + 1) & (UART_RX_SIZE - 1);
+        if(next == rxTail){
+            uart_rxDropped++;//foreground has not kept up
+            continue;
+        }
+        rxBuffer[rxHead] = (char)(data & 0xFF);
+        rxHead = next;
+    }
+}
 /**
  * Initialize uart
  * @author Jordan Fox, Scott Beard
@@ -55,24 +122,84 @@ void uart_init(void){
     //set baud rate
     UART1_IBRD_R = iBRD;
     UART1_FBRD_R = fBRD;
-    //set frame, 8 data bits, 1 stop bit, no parity, no FIFO
-    UART1_LCRH_R = UART_LCRH_WLEN_8 ;
+    //set frame, 8 data bits, 1 stop bit, no parity, FIFO on so bytes survive until the interrupt runs
+    UART1_LCRH_R = (UART_LCRH_WLEN_8 | UART_LCRH_FEN);
     //use system clock as source
     UART1_CC_R = UART_CC_CS_SYSCLK;
+
+    //interrupt when the receive FIFO is half full, the receive timeout catches anything less
+    //interrupt when the transmit FIFO drains to 1/8 so it can be refilled from the transmit queue
+    UART1_IFLS_R = UART_IFLS_RX4_8 | UART_IFLS_TX1_8;
+    UART1_ICR_R = (UART_ICR_RXIC | UART_ICR_RTIC | UART_ICR_OEIC | UART_ICR_FEIC | UART_ICR_TXIC);
+    UART1_IM_R |= (UART_IM_RXIM | UART_IM_RTIM | UART_IM_OEIM | UART_IM_FEIM | UART_IM_TXIM);
+    //enable interrupt for IRQ 6, UART1
+    NVIC_EN0_R |= 0x40;
+    //tell cpu to use ISR handler for UART1
+    IntRegister(INT_UART1, UART1_Handler);
+    //enable global interrupts
+    IntMasterEnable();
+
     //re-enable enable RX, TX, and uart1
     UART1_CTL_R = (UART_CTL_RXE | UART_CTL_TXE | UART_CTL_UARTEN);
 }
 /**
- * Transmit character
+ * Queue character for transmission, waits only while the transmit queue is full
  * @author Jordan Fox, Scott Beard
  * @date 12/2/2018
  */
 void uart_sendChar(char data){
-    //wait until there is room to send data
-    while(UART1_FR_R & 0x20);
-    //send data
-    UART1_DR_R = data;
+    //wait until there is room in the transmit queue
+    while(!uart_sendAsync(&data, 1));
+}
+/**
+ * Queue characters for transmission without waiting, the uart interrupt sends them in the background
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ * @param data characters to send
+ * @param len number of characters to send
+ * @return number of characters queued, less than len if the transmit queue filled up
+ */
+int uart_sendAsync(const char *data, int len){
+    int n = 0;
+    uint32_t head = txHead;
+    uint32_t next;
+    while(n < len){
+        next = (head + 1) & (UART_TX_SIZE - 1);
+        if(next == txTail)
+            break;//queue full
+        txBuffer[head] = data[n++];
+        head = next;
+    }
+    txHead = head;
 
+    //start transmission, the interrupt keeps it going once the FIFO has been filled
+    UART1_IM_R &= ~UART_IM_TXIM;
+    uart_txFill();
+    UART1_IM_R |= UART_IM_TXIM;
+    return n;
+}
+/**
+ * Number of characters that can be queued without waiting
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ * @return free space in the transmit queue
+ */
+int uart_txFree(void){
+    return (txTail - txHead - 1) & (UART_TX_SIZE - 1);
+}
+/**
+ * Wait until every queued character has left the uart
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ */
+void uart_flush(void){
+    while(txTail != txHead){
+        //keep the queue moving even if called with interrupts disabled
+        UART1_IM_R &= ~UART_IM_TXIM;
+        uart_txFill();
+        UART1_IM_R |= UART_IM_TXIM;
+    }
+    while(UART1_FR_R & UART_FR_BUSY);
 }
 /**
  * Receive character via uart
@@ -81,23 +208,38 @@ void uart_sendChar(char data){
  */
 char uart_receive(void){
     char data = 0;
-     //wait to receive
-     while(UART1_FR_R & UART_FR_RXFE);//while fifo empty
-    //mask the 4 error bits and grab only 8 data bits
-    data = (char)(UART1_DR_R & 0xFF);
+    //wait to receive
+    while(!uart_tryReceive(&data));
 
     return data;
 }
 /**
- * Send string via uart
+ * Take the oldest received character without waiting
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ * @param data set to the received character
+ * @return 1 if a character was received, 0 if the receive buffer is empty
+ */
+int uart_tryReceive(char *data){
+    if(rxTail == rxHead)
+        return 0;
+    *data = rxBuffer[rxTail];
+    rxTail = (rxTail + 1) & (UART_RX_SIZE - 1);
+    return 1;
+}
+/**
+ * Queue string for transmission, waits only while the transmit queue is full
  * @author Jordan Fox, Scott Beard
  * @date 12/2/2018
  */
 void uart_sendStr(const char *data){
+    int len = strlen(data);
+    int n;
 
-    while(*data != '\0')//go until it reaches a null byte
+    while(len > 0)//only waits while the transmit queue is full
     {
-        uart_sendChar(*data);//send char
-        data++;//increment pointer value ie next char in string
+        n = uart_sendAsync(data, len);
+        data += n;
+        len -= n;
     }
 }
@@ -11,6 +11,12 @@
 #include "Timer.h"
 //#include "WiFi.h"
 #include <inc/tm4c123gh6pm.h>
+
+//receive error counters, updated by the uart1 interrupt
+extern volatile uint32_t uart_overrunErrors; //FIFO overflowed before the interrupt ran
+extern volatile uint32_t uart_framingErrors; //byte had no valid stop bit and was discarded
+extern volatile uint32_t uart_rxDropped; //receive buffer was full and the byte was discarded
+
 /**
  * Initialize uart
  * @author Jordan Fox, Scott Beard
@@ -18,11 +24,33 @@
  */
 void uart_init(void);
 /**
- * Transmit character
+ * Queue character for transmission, waits only while the transmit queue is full
  * @author Jordan Fox, Scott Beard
  * @date 12/2/2018
  */
 void uart_sendChar(char data);
+/**
+ * Queue characters for transmission without waiting, the uart interrupt sends them in the background
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ * @param data characters to send
+ * @param len number of characters to send
+ * @return number of characters queued, less than len if the transmit queue filled up
+ */
+int uart_sendAsync(const char *data, int len);
+/**
+ * Number of characters that can be queued without waiting
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ * @return free space in the transmit queue
+ */
+int uart_txFree(void);
+/**
+ * Wait until every queued character has left the uart
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ */
+void uart_flush(void);
 /**
  * Receive character via uart
  * @author Jordan Fox, Scott Beard
@@ -30,7 +58,15 @@ void uart_sendChar(char data);
  */
 char uart_receive(void);
 /**
- * Send string via uart
+ * Take the oldest received character without waiting
+ * @author Jordan Fox, Scott Beard
+ * @date 12/2/2018
+ * @param data set to the received character
+ * @return 1 if a character was received, 0 if the receive buffer is empty
+ */
+int uart_tryReceive(char *data);
+/**
+ * Queue string for transmission, waits only while the transmit queue is full
  * @author Jordan Fox, Scott Beard
  * @date 12/2/2018
  */